@@ -0,0 +1,398 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+// Benchmarks of each stage of json_to_cpp over synthetic documents.  The
+// documents are generated, so every run measures the same input.  Each
+// benchmark also reports the number of allocations, bytes allocated and
+// copies of ti_object, ti_array and ti_kv per iteration.  The copies are
+// counted because the library is built with JSON_TO_CPP_COUNT_COPIES
+
+#include "json_events.h"
+#include "json_source.h"
+#include "json_to_cpp.h"
+#include "mapped_file.h"
+#include "types/ti_base.h"
+
+#include <benchmark/benchmark.h>
+#include <daw/daw_string_view.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+	std::atomic<std::size_t> allocation_count{ 0 };
+	std::atomic<std::size_t> allocation_bytes{ 0 };
+} // namespace
+
+void *operator new( std::size_t size ) {
+	allocation_count.fetch_add( 1, std::memory_order_relaxed );
+	allocation_bytes.fetch_add( size, std::memory_order_relaxed );
+	if( void *ptr = std::malloc( size == 0 ? 1 : size ) ) {
+		return ptr;
+	}
+	throw std::bad_alloc( );
+}
+
+// GCC sees the free of memory from a new expression once these are inlined
+#if defined( __GNUC__ ) and not defined( __clang__ )
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete( void *ptr ) noexcept {
+	std::free( ptr );
+}
+
+void operator delete( void *ptr, std::size_t ) noexcept {
+	std::free( ptr );
+}
+
+namespace {
+	using namespace daw::json_to_cpp;
+
+	enum class corpus_t { wide, deep, huge_array, kv_map };
+
+	/// One object with many members of every kind
+	std::string make_wide( ) {
+		std::string result = "{";
+		for( int n = 0; n < 2000; ++n ) {
+			if( n > 0 ) {
+				result += ',';
+			}
+			result += "\"member_" + std::to_string( n ) + "\":";
+			switch( n % 5 ) {
+			case 0:
+				result += std::to_string( n );
+				break;
+			case 1:
+				result += std::to_string( n ) + ".5";
+				break;
+			case 2:
+				result += "\"value " + std::to_string( n ) + "\"";
+				break;
+			case 3:
+				result += n % 2 == 0 ? "true" : "null";
+				break;
+			default:
+				result += "{\"a\":" + std::to_string( n ) + ",\"b\":[1,2,3]}";
+				break;
+			}
+		}
+		result += '}';
+		return result;
+	}
+
+	/// Objects and arrays nested to a large depth
+	std::string make_deep( ) {
+		constexpr int depth = 500;
+		std::string result;
+		for( int n = 0; n < depth; ++n ) {
+			result += "{\"level_" + std::to_string( n ) + "\":[";
+		}
+		result += "{\"leaf\":true}";
+		for( int n = 0; n < depth; ++n ) {
+			result += "]}";
+		}
+		return result;
+	}
+
+	/// A large array of records of the same shape with some optional members
+	std::string make_huge_array( ) {
+		std::string result = "[";
+		for( int n = 0; n < 100000; ++n ) {
+			if( n > 0 ) {
+				result += ',';
+			}
+			result += "{\"id\":" + std::to_string( n ) + ",\"name\":\"record " + std::to_string( n ) +
+			          "\",\"score\":" + std::to_string( n % 100 ) + ".25,\"tags\":[\"a\",\"b\"]";
+			if( n % 7 == 0 ) {
+				result += ",\"note\":null";
+			}
+			if( n % 11 == 0 ) {
+				result += ",\"extra\":{\"x\":1,\"y\":2}";
+			}
+			result += '}';
+		}
+		result += ']';
+		return result;
+	}
+
+	/// A KV map, inferred with --kv_paths entries
+	std::string make_kv_map( ) {
+		std::string result = "{\"entries\":{";
+		for( int n = 0; n < 50000; ++n ) {
+			if( n > 0 ) {
+				result += ',';
+			}
+			result += "\"key_" + std::to_string( n ) + "\":{\"count\":" + std::to_string( n ) +
+			          ",\"ratio\":0." + std::to_string( n % 10 ) + "}";
+		}
+		result += "}}";
+		return result;
+	}
+
+	std::string const &corpus( corpus_t which ) {
+		static auto const wide = make_wide( );
+		static auto const deep = make_deep( );
+		static auto const huge_array = make_huge_array( );
+		static auto const kv_map = make_kv_map( );
+		switch( which ) {
+		case corpus_t::wide:
+			return wide;
+		case corpus_t::deep:
+			return deep;
+		case corpus_t::huge_array:
+			return huge_array;
+		case corpus_t::kv_map:
+			break;
+		}
+		return kv_map;
+	}
+
+	daw::string_view corpus_view( corpus_t which ) {
+		auto const &doc = corpus( which );
+		return daw::string_view( doc.data( ), doc.size( ) );
+	}
+
+	/// The corpus written to a temporary file, for the loading benchmark
+	std::filesystem::path const &corpus_file( corpus_t which ) {
+		static auto files = std::vector<std::filesystem::path>( 4 );
+		auto &result = files[static_cast<std::size_t>( which )];
+		if( result.empty( ) ) {
+			result = std::filesystem::temp_directory_path( ) /
+			         ( "json_to_cpp_bench_" + std::to_string( static_cast<int>( which ) ) + ".json" );
+			auto out = std::ofstream( result, std::ios::binary | std::ios::trunc );
+			out << corpus( which );
+		}
+		return result;
+	}
+
+	config_t make_config( ) {
+		auto result = config_t( );
+		result.root_object_name = "root_object";
+		result.kv_paths = { { "root_object", "entries" } };
+		result.hide_null_only = true;
+		result.use_string_view = false;
+		result.has_cpp20 = false;
+		return result;
+	}
+
+	class null_handler final : public json_event_handler {
+	public:
+		std::size_t events = 0;
+
+		void on_object_begin( ) override {
+			++events;
+		}
+		void on_member_name( daw::string_view ) override {
+			++events;
+		}
+		void on_object_end( ) override {
+			++events;
+		}
+		void on_array_begin( ) override {
+			++events;
+		}
+		void on_array_end( ) override {
+			++events;
+		}
+		void on_string( daw::string_view ) override {
+			++events;
+		}
+		void on_number( daw::string_view, bool ) override {
+			++events;
+		}
+		void on_boolean( bool ) override {
+			++events;
+		}
+		void on_null( ) override {
+			++events;
+		}
+	};
+
+	/// Counts allocations and copies while alive and reports them per
+	/// iteration
+	class allocation_counter {
+		benchmark::State *m_state;
+		std::size_t m_count;
+		std::size_t m_bytes;
+		std::size_t m_copies;
+		std::size_t m_excluded_count = 0;
+		std::size_t m_excluded_bytes = 0;
+		std::size_t m_excluded_copies = 0;
+		std::size_t m_pause_count = 0;
+		std::size_t m_pause_bytes = 0;
+		std::size_t m_pause_copies = 0;
+
+	public:
+		explicit allocation_counter( benchmark::State &state )
+		  : m_state( &state )
+		  , m_count( allocation_count.load( ) )
+		  , m_bytes( allocation_bytes.load( ) )
+		  , m_copies( types::impl::subtree_copy_count.load( ) ) {}
+
+		allocation_counter( allocation_counter const & ) = delete;
+		allocation_counter &operator=( allocation_counter const & ) = delete;
+
+		/// Pause the timing and the counting for untimed setup
+		void pause( ) {
+			m_state->PauseTiming( );
+			m_pause_count = allocation_count.load( );
+			m_pause_bytes = allocation_bytes.load( );
+			m_pause_copies = types::impl::subtree_copy_count.load( );
+		}
+
+		void resume( ) {
+			m_excluded_count += allocation_count.load( ) - m_pause_count;
+			m_excluded_bytes += allocation_bytes.load( ) - m_pause_bytes;
+			m_excluded_copies += types::impl::subtree_copy_count.load( ) - m_pause_copies;
+			m_state->ResumeTiming( );
+		}
+
+		~allocation_counter( ) {
+			auto const iterations = static_cast<double>( m_state->iterations( ) );
+			if( iterations == 0.0 ) {
+				return;
+			}
+			m_state->counters["allocs"] =
+			  static_cast<double>( allocation_count.load( ) - m_count - m_excluded_count ) /
+			  iterations;
+			m_state->counters["alloc_bytes"] =
+			  static_cast<double>( allocation_bytes.load( ) - m_bytes - m_excluded_bytes ) /
+			  iterations;
+			m_state->counters["copies"] =
+			  static_cast<double>( types::impl::subtree_copy_count.load( ) - m_copies - m_excluded_copies ) /
+			  iterations;
+		}
+	};
+
+	void set_bytes_processed( benchmark::State &state, corpus_t which ) {
+		state.SetBytesProcessed( static_cast<std::int64_t>( state.iterations( ) ) *
+		                         static_cast<std::int64_t>( corpus( which ).size( ) ) );
+	}
+
+	void BM_load_file( benchmark::State &state, corpus_t which ) {
+		auto const &path = corpus_file( which );
+		auto const counter = allocation_counter( state );
+		for( auto _ : state ) {
+			auto file = mapped_file_t( path );
+			// Touch every page, mapping alone does not read the file
+			std::size_t sum = 0;
+			auto const data = file.view( );
+			for( std::size_t n = 0; n < data.size( ); n += 4096 ) {
+				sum += static_cast<unsigned char>( data[n] );
+			}
+			benchmark::DoNotOptimize( sum );
+		}
+		set_bytes_processed( state, which );
+	}
+
+	void BM_tokenize( benchmark::State &state, corpus_t which ) {
+		auto const doc = corpus_view( which );
+		auto const counter = allocation_counter( state );
+		for( auto _ : state ) {
+			auto source = string_source( doc );
+			auto parser = json_event_parser( source );
+			auto handler = null_handler( );
+			parser.parse_value( handler );
+			benchmark::DoNotOptimize( handler.events );
+		}
+		set_bytes_processed( state, which );
+	}
+
+	void BM_infer_schema( benchmark::State &state, corpus_t which ) {
+		auto const config = make_config( );
+		auto const doc = corpus_view( which );
+		auto const counter = allocation_counter( state );
+		for( auto _ : state ) {
+			auto schema = infer_schema( doc, config );
+			benchmark::DoNotOptimize( schema.obj_info.size( ) );
+		}
+		set_bytes_processed( state, which );
+	}
+
+	/// The add_or_merge of every object of one schema into another.  Merging
+	/// consumes the schemas, so they are inferred again outside of the timing
+	/// each iteration
+	void BM_merge_schema( benchmark::State &state, corpus_t which ) {
+		auto const config = make_config( );
+		auto const doc = corpus_view( which );
+		auto counter = allocation_counter( state );
+		for( auto _ : state ) {
+			counter.pause( );
+			auto lhs = infer_schema( doc, config );
+			auto rhs = infer_schema( doc, config );
+			counter.resume( );
+			merge_schema( lhs, std::move( rhs ) );
+			benchmark::DoNotOptimize( lhs.obj_info.size( ) );
+		}
+	}
+
+	void BM_generate_declarations( benchmark::State &state, corpus_t which ) {
+		auto config = make_config( );
+		auto const schema = infer_schema( corpus_view( which ), config );
+		auto out = std::ostringstream( );
+		config.header_stream = &out;
+		auto const counter = allocation_counter( state );
+		for( auto _ : state ) {
+			out.str( std::string( ) );
+			generate_declarations( schema, config );
+		}
+	}
+
+	/// generate_declarations of the wide corpus, with its 401 object types, with
+	/// render_block_size set to the argument.  A block as large as the schema
+	/// renders it on one thread
+	void BM_render_block_size( benchmark::State &state ) {
+		auto config = make_config( );
+		config.render_block_size = static_cast<std::size_t>( state.range( 0 ) );
+		auto const schema = infer_schema( corpus_view( corpus_t::wide ), config );
+		auto out = std::ostringstream( );
+		config.header_stream = &out;
+		auto const counter = allocation_counter( state );
+		for( auto _ : state ) {
+			out.str( std::string( ) );
+			generate_declarations( schema, config );
+		}
+	}
+
+	void BM_generate_definitions( benchmark::State &state, corpus_t which ) {
+		auto config = make_config( );
+		auto const schema = infer_schema( corpus_view( which ), config );
+		auto out = std::ostringstream( );
+		config.cpp_stream = &out;
+		auto const counter = allocation_counter( state );
+		for( auto _ : state ) {
+			out.str( std::string( ) );
+			generate_definitions( schema, config );
+		}
+	}
+} // namespace
+
+#define JSON_TO_CPP_BENCHMARK( Name, ... )                                                         \
+	BENCHMARK_CAPTURE( Name, wide, corpus_t::wide ) __VA_ARGS__;                                     \
+	BENCHMARK_CAPTURE( Name, deep, corpus_t::deep ) __VA_ARGS__;                                     \
+	BENCHMARK_CAPTURE( Name, huge_array, corpus_t::huge_array ) __VA_ARGS__;                         \
+	BENCHMARK_CAPTURE( Name, kv_map, corpus_t::kv_map ) __VA_ARGS__
+
+JSON_TO_CPP_BENCHMARK( BM_load_file );
+JSON_TO_CPP_BENCHMARK( BM_tokenize );
+JSON_TO_CPP_BENCHMARK( BM_infer_schema );
+// The untimed setup of each iteration is far slower than the merge, so a
+// time based iteration count would take too long
+JSON_TO_CPP_BENCHMARK( BM_merge_schema, ->Iterations( 20 ) );
+JSON_TO_CPP_BENCHMARK( BM_generate_declarations );
+JSON_TO_CPP_BENCHMARK( BM_generate_definitions );
+BENCHMARK( BM_render_block_size )->Arg( 8 )->Arg( 32 )->Arg( 64 )->Arg( 128 )->Arg( 1024 )->UseRealTime( );
+
+BENCHMARK_MAIN( );
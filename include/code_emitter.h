@@ -0,0 +1,80 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <daw/daw_string_view.h>
+#include <fmt/format.h>
+
+namespace daw::json_to_cpp {
+	/// Assembles generated code in memory so that a whole file is written to
+	/// its stream at once
+	class code_emitter_t {
+		fmt::memory_buffer m_buffer{ };
+
+	public:
+		code_emitter_t( ) = default;
+
+		code_emitter_t( code_emitter_t const & ) = delete;
+		code_emitter_t &operator=( code_emitter_t const & ) = delete;
+
+		code_emitter_t &operator<<( std::string_view str ) {
+			m_buffer.append( str.data( ), str.data( ) + str.size( ) );
+			return *this;
+		}
+
+		code_emitter_t &operator<<( std::string const &str ) {
+			return *this << std::string_view( str );
+		}
+
+		code_emitter_t &operator<<( char const *str ) {
+			return *this << std::string_view( str );
+		}
+
+		code_emitter_t &operator<<( daw::string_view str ) {
+			return *this << std::string_view( str.data( ), str.size( ) );
+		}
+
+		code_emitter_t &operator<<( char c ) {
+			m_buffer.push_back( c );
+			return *this;
+		}
+
+		template<typename... Args>
+		code_emitter_t &format( fmt::format_string<Args...> fmt_str, Args &&...args ) {
+			fmt::format_to( std::back_inserter( m_buffer ), fmt_str, std::forward<Args>( args )... );
+			return *this;
+		}
+
+		/// Append the output of another emitter
+		void append( code_emitter_t const &other ) {
+			m_buffer.append( other.m_buffer.data( ), other.m_buffer.data( ) + other.m_buffer.size( ) );
+		}
+
+		std::string_view view( ) const noexcept {
+			return std::string_view( m_buffer.data( ), m_buffer.size( ) );
+		}
+
+		std::size_t size( ) const noexcept {
+			return m_buffer.size( );
+		}
+
+		/// Write everything assembled so far with a single write and start over
+		void flush_to( std::ostream &os ) {
+			os.write( m_buffer.data( ), static_cast<std::streamsize>( m_buffer.size( ) ) );
+			m_buffer.clear( );
+		}
+	};
+} // namespace daw::json_to_cpp
@@ -8,13 +8,90 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
 #include <optional>
+#include <string>
+#include <vector>
 
 #include <daw/daw_string_view.h>
 
 namespace daw::curl {
-	std::optional<std::string> download( daw::string_view url,
-	                                     daw::string_view user_agent );
+	/// Initialize libcurl.  Must be called before downloading from more than
+	/// one thread
+	void global_init( );
+
+	/// The body of one download, passed in parts from the thread running
+	/// download_all to a reader on another thread.  At most capacity bytes wait
+	/// to be read, the transfer is paused while the reader is behind, so memory
+	/// use does not grow with the size of the body
+	class body_stream_t {
+		std::mutex m_lock{ };
+		std::condition_variable m_changed{ };
+		// Written by download_all, swapped with m_reading by read
+		std::string m_filling{ };
+		std::string m_reading{ };
+		std::size_t m_capacity;
+		// The multi handle of download_all, woken to resume a paused transfer
+		void *m_multi = nullptr;
+		bool m_paused = false;
+		bool m_finished = false;
+		bool m_is_ok = true;
+		bool m_closed = false;
+
+	public:
+		static constexpr std::size_t default_capacity = 64U * 1024U;
+		/// Never pauses the transfer, for a body that is needed whole
+		static constexpr std::size_t unbounded = static_cast<std::size_t>( -1 );
+
+		explicit body_stream_t( std::size_t capacity = default_capacity );
+
+		body_stream_t( body_stream_t const & ) = delete;
+		body_stream_t( body_stream_t && ) = delete;
+		body_stream_t &operator=( body_stream_t const & ) = delete;
+		body_stream_t &operator=( body_stream_t && ) = delete;
+
+		/// Wait for the next part of the body
+		/// \return The part, valid until the next call, or an empty view once
+		/// the download has ended
+		daw::string_view read( );
+
+		/// Wait for the rest of the body
+		/// \return The rest, or nothing if the download failed
+		std::optional<std::string> read_all( );
+
+		/// \pre The download has ended
+		bool is_ok( );
+
+		/// The reader is done, the rest of the body is discarded
+		void close( );
+
+		// Used by download_all
+		void attach( void *multi );
+		/// \return false to pause the transfer, data is offered again once
+		/// resume returns true
+		bool write( daw::string_view data );
+		bool resume( );
+		void finish( bool is_ok );
+	};
+
+	/// Called when the download of urls[index] starts
+	/// \return Where its body goes.  It must outlive the download
+	using stream_for_t = std::function<body_stream_t &( std::size_t index )>;
+
+	/// Download urls with up to max_connections transfers at a time.  Each body
+	/// is written to a stream as it arrives, so it can be read on another thread
+	/// while the transfer runs.  Connections are reused between transfers to
+	/// the same host.  Setting cancelled stops the downloads that have not
+	/// finished, the streams of those that started are finished as failed
+	void download_all( std::vector<std::string> const &urls,
+	                   daw::string_view user_agent,
+	                   std::size_t max_connections,
+	                   stream_for_t const &stream_for,
+	                   std::atomic<bool> const *cancelled = nullptr );
 
 	bool is_url( daw::string_view path );
 } // namespace daw::curl
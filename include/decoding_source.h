@@ -0,0 +1,48 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#pragma once
+
+#include <memory>
+
+#include <daw/daw_string_view.h>
+
+#include "json_source.h"
+
+namespace daw::json_to_cpp {
+	enum class compression_t { none, gzip, zstd, xz };
+
+	/// \return The compression format whose magic number starts data
+	compression_t detect_compression( daw::string_view data ) noexcept;
+
+	/// A source that decodes the chunks of another source as they are read.
+	/// The format is detected from the first bytes, so gzip, zstd and xz input
+	/// is decompressed and anything else is passed through unchanged.  The
+	/// plain text is never held in full, only one decoded chunk at a time
+	class decoding_source final : public json_source {
+		// source, with the bytes that were read to detect the format put back
+		std::unique_ptr<json_source> m_raw;
+		// Reads from m_raw, null if the input is not compressed
+		std::unique_ptr<json_source> m_decoder{ };
+		compression_t m_compression = compression_t::none;
+
+	public:
+		/// \throws std::runtime_error if source is compressed in a format that
+		/// this build cannot decode
+		explicit decoding_source( json_source &source );
+		~decoding_source( ) override;
+
+		compression_t compression( ) const noexcept {
+			return m_compression;
+		}
+
+		/// \throws std::runtime_error if the compressed data is corrupt or
+		/// truncated
+		daw::string_view next_chunk( ) override;
+	};
+} // namespace daw::json_to_cpp
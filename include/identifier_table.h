@@ -0,0 +1,56 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "types/ti_arena.h"
+
+namespace daw::json_to_cpp {
+	/// Add a "json_" prefix to C++ keywords and escape non representable
+	/// characters
+	///
+	/// \param name Name of identifier
+	/// \return A valid C++ identifier
+	std::string make_compliant_names( std::string name );
+
+	struct identifier_stats_t {
+		std::size_t hits = 0;
+		std::size_t misses = 0;
+
+		identifier_stats_t &operator+=( identifier_stats_t const &rhs ) noexcept {
+			hits += rhs.hits;
+			misses += rhs.misses;
+			return *this;
+		}
+	};
+
+	/// Memoizes make_compliant_names.  Both the raw names and the identifiers
+	/// are interned in a ti_arena, so a name that was seen before costs one
+	/// lookup and no allocation.  Not thread safe
+	class identifier_table_t {
+		types::ti_arena *m_arena;
+		std::pmr::unordered_map<std::string_view, std::string_view> m_identifiers;
+		identifier_stats_t m_stats{ };
+
+	public:
+		explicit identifier_table_t( types::ti_arena &arena );
+
+		/// \return The identifier for the raw JSON name, interned in the arena
+		std::string_view get( std::string_view name );
+
+		identifier_stats_t const &stats( ) const noexcept {
+			return m_stats;
+		}
+	};
+} // namespace daw::json_to_cpp
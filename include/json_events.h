@@ -0,0 +1,95 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <daw/daw_string_view.h>
+
+#include "json_source.h"
+
+namespace daw::json_to_cpp {
+	struct json_parse_error : std::runtime_error {
+		std::size_t offset;
+
+		json_parse_error( std::string const &message, std::size_t pos );
+	};
+
+	/// Receives the structure of a JSON document as it is parsed.  String
+	/// values and member names are passed unprocessed, escapes included, and
+	/// are only valid for the duration of the call
+	class json_event_handler {
+	public:
+		json_event_handler( ) = default;
+		virtual ~json_event_handler( ) = default;
+
+		json_event_handler( json_event_handler const & ) = delete;
+		json_event_handler &operator=( json_event_handler const & ) = delete;
+
+		virtual void on_object_begin( ) = 0;
+		virtual void on_member_name( daw::string_view name ) = 0;
+		virtual void on_object_end( ) = 0;
+		virtual void on_array_begin( ) = 0;
+		/// Called before each element of an array
+		/// \return false to skip the element without reporting its events
+		virtual bool on_array_element( ) {
+			return true;
+		}
+		virtual void on_array_end( ) = 0;
+		virtual void on_string( daw::string_view value ) = 0;
+		virtual void on_number( daw::string_view value, bool is_real ) = 0;
+		virtual void on_boolean( bool value ) = 0;
+		virtual void on_null( ) = 0;
+	};
+
+	/// An incremental JSON parser that reports events instead of building a
+	/// document.  Memory use is bounded by the nesting depth and the longest
+	/// single token, not by the size of the input
+	class json_event_parser {
+		json_source *m_source;
+		daw::string_view m_chunk{ };
+		std::size_t m_offset = 0;
+		std::string m_token{ };
+		std::vector<char> m_stack{ };
+
+		bool fill( );
+		char peek( );
+		char get( );
+		void expect( char c );
+		void skip_ws( );
+		[[noreturn]] void error( char const *message ) const;
+
+		void read_string( );
+		void skip_string( );
+		void skip_value( );
+		bool read_number( );
+		void read_literal( daw::string_view literal );
+
+	public:
+		explicit json_event_parser( json_source &source ) noexcept;
+
+		/// Parse the next JSON value from the source
+		/// \return false if the input ended before another value started
+		bool parse_value( json_event_handler &handler );
+
+		/// Parse the source as a single JSON value, with nothing but whitespace
+		/// after it
+		/// \throws json_parse_error if the source is empty or has more after the
+		/// value
+		void parse_document( json_event_handler &handler );
+
+		/// \return Number of bytes of input consumed so far
+		std::size_t offset( ) const noexcept {
+			return m_offset;
+		}
+	};
+} // namespace daw::json_to_cpp
@@ -0,0 +1,70 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+#include <daw/daw_string_view.h>
+
+namespace daw::json_to_cpp {
+	/// A pull based supplier of JSON text.  The parser asks for the next chunk
+	/// whenever it has consumed the previous one, so only one chunk needs to be
+	/// alive at a time.
+	class json_source {
+	public:
+		json_source( ) = default;
+		virtual ~json_source( ) = default;
+
+		json_source( json_source const & ) = delete;
+		json_source &operator=( json_source const & ) = delete;
+
+		/// \return The next chunk of input, or an empty view at the end of input.
+		/// The returned view must stay valid until the next call
+		virtual daw::string_view next_chunk( ) = 0;
+	};
+
+	/// A source over a buffer that is already in memory
+	class string_source final : public json_source {
+		daw::string_view m_data;
+
+	public:
+		explicit string_source( daw::string_view data ) noexcept;
+
+		daw::string_view next_chunk( ) override;
+	};
+
+	/// A source that reads a file in fixed size chunks, so that memory use does
+	/// not grow with the size of the file.  Works with pipes and other files
+	/// that cannot be memory mapped
+	class file_source final : public json_source {
+		std::FILE *m_file = nullptr;
+		bool m_owns_file = false;
+		std::vector<char> m_buffer;
+
+	public:
+		static constexpr std::size_t default_chunk_size = 64U * 1024U;
+
+		/// Open path for reading.  Check the result with operator bool
+		explicit file_source( std::filesystem::path const &path,
+		                      std::size_t chunk_size = default_chunk_size );
+		/// Read from an already open file, e.g. stdin.  The file is not closed
+		explicit file_source( std::FILE *file, std::size_t chunk_size = default_chunk_size );
+		~file_source( ) override;
+
+		explicit operator bool( ) const noexcept {
+			return m_file != nullptr;
+		}
+
+		/// \throws std::runtime_error if reading fails
+		daw::string_view next_chunk( ) override;
+	};
+} // namespace daw::json_to_cpp
@@ -8,10 +8,86 @@
 
 #pragma once
 
+#include "identifier_table.h"
+#include "json_source.h"
 #include "json_to_cpp_config.h"
+#include "object_registry.h"
+#include "types/ti_arena.h"
+#include "types/ti_types.h"
 
 #include <daw/daw_string_view.h>
 
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace daw::json_to_cpp {
+	struct state_t {
+		bool has_arrays = false;
+		bool has_integrals = false;
+		bool has_optionals = false;
+		bool has_strings = false;
+		bool has_kv = false;
+		/// Only set while generating code, these depend on the whole schema
+		bool has_enums = false;
+		bool has_cold_members = false;
+		bool has_fixed_arrays = false;
+		bool has_small_vectors = false;
+		bool has_columns = false;
+	};
+
+	/// The types inferred from one or more JSON documents.  The types are
+	/// stored in the arenas of the runs that found them
+	struct schema_t {
+		std::vector<std::unique_ptr<types::ti_arena>> arenas{ };
+		object_registry_t obj_info{ };
+		state_t state{ };
+		identifier_stats_t identifier_stats{ };
+	};
+
+	schema_t infer_schema( daw::string_view json_string, config_t const &config );
+
+	/// Infer the types of the JSON document read from source.  Only one chunk
+	/// of the source is held at a time
+	schema_t infer_schema( json_source &source, config_t const &config );
+
+	/// Infer the types of a stream of JSON values, such as NDJSON / JSON Lines,
+	/// as if each value were another instance of the root.  Each value is
+	/// merged as soon as it is parsed, so memory use does not grow with the
+	/// number of values
+	schema_t infer_ndjson_schema( json_source &source, config_t const &config );
+
+	/// Merge the types of rhs into lhs, using the same rules as when two
+	/// instances of an object are found in one document.  lhs takes over the
+	/// arenas of rhs
+	void merge_schema( schema_t &lhs, schema_t rhs );
+
+	/// Reduce the schemas pairwise in parallel.  The result is the same as
+	/// merging them from front to back
+	schema_t merge_schemas( std::vector<schema_t> schemas );
+
+	void generate_code( schema_t const &schema, config_t &config );
+
+	/// Write only the struct declarations of generate_code to the header file
+	void generate_declarations( schema_t const &schema, config_t &config );
+
+	/// Write only the json_data_contract specializations of generate_code to
+	/// the cpp file
+	void generate_definitions( schema_t const &schema, config_t &config );
+
+	/// A generated file, named relative to the output directory
+	struct generated_file_t {
+		std::string name;
+		std::string content;
+	};
+
+	/// Split the output of generate_code into headers of shard_size types each,
+	/// so that a translation unit only pays for the types it includes.  Shards
+	/// are in dependency order and include the shards their members need.
+	/// Also returns <root>_fwd.h with forward declarations of every type and
+	/// <root>.h, which includes every shard
+	std::vector<generated_file_t>
+	generate_sharded_code( schema_t const &schema, config_t const &config, std::size_t shard_size );
+
 	void generate_cpp( daw::string_view json_string, config_t &config );
 } // namespace daw::json_to_cpp
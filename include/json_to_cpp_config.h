@@ -8,13 +8,30 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <iostream>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace daw::json_to_cpp {
+	/// Which elements of an array are used to infer the element type
+	enum class array_sampling_t {
+		/// Every element
+		all,
+		/// The first sample_count elements
+		first_n,
+		/// The first sample_count elements, then element i with probability
+		/// sample_count / i
+		reservoir,
+		/// Stop once sample_count elements in a row did not change any type
+		until_stable
+	};
+
 	struct config_t final {
 		bool enable_jsonlink = true;
 		std::ostream *header_stream = nullptr;
@@ -24,18 +41,52 @@ namespace daw::json_to_cpp {
 		std::string type_suffix{ };
 		std::optional<std::string> path{ };
 		std::filesystem::path cpp_path;
-		std::filesystem::path json_path;
+		std::vector<std::filesystem::path> json_paths;
 		std::vector<std::vector<std::string>> kv_paths;
 		bool hide_null_only;
 		bool use_string_view;
 		bool has_cpp20;
+		array_sampling_t array_sampling = array_sampling_t::all;
+		std::size_t sample_count = 100;
+		std::uint64_t sample_seed = 0;
+		/// Each input is a stream of values that are each an instance of the
+		/// root object
+		bool ndjson = false;
+		/// Generate the narrowest integer type that holds the range of the values
+		/// seen, and float for reals that were all exact as a float
+		bool narrow_numbers = false;
+		/// Bits of range a narrowed integer has beyond the values seen, each
+		/// doubles the range
+		std::size_t narrow_margin_bits = 1;
+		/// Generate an enum class for strings with at most this many distinct
+		/// values.  0 disables enums
+		std::size_t enum_max_values = 0;
+		/// Generate std::array for arrays that always had the same length, when
+		/// it is at most this.  0 disables it
+		std::size_t fixed_array_max = 0;
+		/// Generate boost::container::small_vector for arrays that were never
+		/// longer than this, with their longest length inline.  0 disables it
+		std::size_t small_vector_max = 0;
+		/// Order the members of structs to avoid padding, with the required
+		/// members before the optional ones
+		bool optimize_layout = false;
+		/// Move optional members present in fewer than this share of the
+		/// instances into a separately allocated struct.  0 disables it
+		double cold_member_ratio = 0.0;
+		/// Also generate a struct with a std::vector per member for the array
+		/// elements whose members are all booleans, numbers or strings
+		bool struct_of_arrays = false;
+		/// Objects rendered by one task when a schema with more objects than
+		/// this is rendered on several cores.  Smaller blocks spread the work
+		/// wider at the cost of more tasks and buffers
+		std::size_t render_block_size = 64;
 
 		std::ostream &header_file( );
 		std::ostream &cpp_file( );
 
-		inline bool path_matches( std::vector<std::string> const &cur_path ) const {
+		inline bool path_matches( std::vector<std::string_view> const &cur_path ) const {
 			for( auto const &kv_path : kv_paths ) {
-				if( kv_path == cur_path ) {
+				if( std::equal( kv_path.begin( ), kv_path.end( ), cur_path.begin( ), cur_path.end( ) ) ) {
 					return true;
 				}
 			}
@@ -0,0 +1,49 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+#include <daw/daw_string_view.h>
+
+namespace daw::json_to_cpp {
+	/// Read only view of a file's contents.  Regular files are memory mapped,
+	/// anything else (pipes, character devices) is read into a buffer in bulk
+	class mapped_file_t {
+		char const *m_data = nullptr;
+		std::size_t m_size = 0;
+		bool m_is_mapped = false;
+		std::string m_buffer{ };
+
+		void close( ) noexcept;
+
+	public:
+		mapped_file_t( ) = default;
+		explicit mapped_file_t( std::filesystem::path const &path );
+		~mapped_file_t( );
+
+		mapped_file_t( mapped_file_t const & ) = delete;
+		mapped_file_t( mapped_file_t && ) = delete;
+		mapped_file_t &operator=( mapped_file_t const & ) = delete;
+		mapped_file_t &operator=( mapped_file_t && ) = delete;
+
+		/// \return true if the file could be opened and read
+		bool open( std::filesystem::path const &path );
+
+		explicit operator bool( ) const noexcept {
+			return m_data != nullptr;
+		}
+
+		daw::string_view view( ) const noexcept {
+			return daw::string_view( m_data, m_size );
+		}
+	};
+} // namespace daw::json_to_cpp
@@ -0,0 +1,139 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <daw/daw_string_view.h>
+
+#include "types/ti_types.h"
+
+namespace daw::json_to_cpp {
+	struct registry_stats_t {
+		std::size_t hits = 0;
+		std::size_t misses = 0;
+		std::size_t inserts = 0;
+		std::size_t merges = 0;
+
+		registry_stats_t &operator+=( registry_stats_t const &rhs ) noexcept {
+			hits += rhs.hits;
+			misses += rhs.misses;
+			inserts += rhs.inserts;
+			merges += rhs.merges;
+			return *this;
+		}
+	};
+
+	/// The object types found so far, indexed by name and kept in the order
+	/// they were first seen.  The names are interned in a ti_arena that must
+	/// outlive the registry and the name of a stored object must not be changed
+	class object_registry_t {
+		std::vector<types::ti_object> m_objects{ };
+		std::unordered_map<std::string_view, std::size_t> m_index{ };
+		// Only the lookups of inference are counted, so that the stats do not
+		// depend on how often code generation looks a name up
+		registry_stats_t m_stats{ };
+
+		/// find_index, counted as a hit or a miss
+		std::size_t counted_index( daw::string_view name );
+
+		void insert( types::ti_object &&obj );
+
+	public:
+		static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max( );
+
+		using iterator = std::vector<types::ti_object>::iterator;
+		using const_iterator = std::vector<types::ti_object>::const_iterator;
+
+		/// \return The position of the object named name, or npos.  Not counted
+		/// in the stats
+		std::size_t find_index( daw::string_view name ) const;
+
+		types::ti_object *find( daw::string_view name );
+		types::ti_object const *find( daw::string_view name ) const;
+
+		/// Find the object named name, storing the result of make( ) if there is
+		/// none yet
+		/// \return The object and whether it was stored
+		template<typename Make>
+		std::pair<types::ti_object *, bool> try_emplace( std::string_view name, Make make ) {
+			auto const idx = counted_index( daw::string_view( name.data( ), name.size( ) ) );
+			if( idx != npos ) {
+				return { &m_objects[idx], false };
+			}
+			insert( make( ) );
+			return { &m_objects.back( ), true };
+		}
+
+		/// Count an instance that was merged into a known object
+		void count_merge( ) noexcept {
+			++m_stats.merges;
+		}
+
+		/// Store obj if there is no object with the same name yet, otherwise call
+		/// merge( existing, obj )
+		/// \return true if obj was inserted or merge returned true
+		template<typename Merge>
+		bool add_or_merge( types::ti_object const &obj, Merge merge ) {
+			auto const idx = counted_index( obj.name( ) );
+			if( idx == npos ) {
+				insert( types::ti_object( obj ) );
+				return true;
+			}
+			++m_stats.merges;
+			return merge( m_objects[idx], obj );
+		}
+
+		registry_stats_t const &stats( ) const noexcept {
+			return m_stats;
+		}
+
+		void add_stats( registry_stats_t const &other ) noexcept {
+			m_stats += other;
+		}
+
+		void reset_stats( ) noexcept {
+			m_stats = registry_stats_t{ };
+		}
+
+		std::size_t size( ) const noexcept {
+			return m_objects.size( );
+		}
+
+		bool empty( ) const noexcept {
+			return m_objects.empty( );
+		}
+
+		types::ti_object const &operator[]( std::size_t idx ) const noexcept {
+			return m_objects[idx];
+		}
+
+		iterator begin( ) noexcept {
+			return m_objects.begin( );
+		}
+
+		iterator end( ) noexcept {
+			return m_objects.end( );
+		}
+
+		const_iterator begin( ) const noexcept {
+			return m_objects.begin( );
+		}
+
+		const_iterator end( ) const noexcept {
+			return m_objects.end( );
+		}
+	};
+} // namespace daw::json_to_cpp
@@ -0,0 +1,62 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace daw::json_to_cpp {
+	/// Call func( n ) for every n in [0, count) on up to one thread per core.
+	/// The first exception thrown by func is rethrown on the calling thread
+	template<typename Function>
+	void parallel_for( std::size_t count, Function func ) {
+		auto const thread_count = std::min<std::size_t>(
+		  count, std::max<std::size_t>( 1U, std::thread::hardware_concurrency( ) ) );
+		if( thread_count <= 1 ) {
+			for( std::size_t n = 0; n < count; ++n ) {
+				func( n );
+			}
+			return;
+		}
+		auto next = std::atomic<std::size_t>( 0 );
+		auto error = std::exception_ptr( );
+		auto error_lock = std::mutex( );
+		auto const worker = [&]( ) {
+			for( auto n = next++; n < count; n = next++ ) {
+				try {
+					func( n );
+				} catch( ... ) {
+					auto const lck = std::lock_guard<std::mutex>( error_lock );
+					if( not error ) {
+						error = std::current_exception( );
+					}
+					// Stop handing out more work
+					next = count;
+				}
+			}
+		};
+		auto threads = std::vector<std::thread>( );
+		threads.reserve( thread_count - 1 );
+		for( std::size_t t = 1; t < thread_count; ++t ) {
+			threads.emplace_back( worker );
+		}
+		worker( );
+		for( auto &thread : threads ) {
+			thread.join( );
+		}
+		if( error ) {
+			std::rethrow_exception( error );
+		}
+	}
+} // namespace daw::json_to_cpp
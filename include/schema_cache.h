@@ -0,0 +1,51 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "json_to_cpp.h"
+#include "json_to_cpp_config.h"
+
+namespace daw::json_to_cpp {
+	/// A fast non-cryptographic 64 bit hash of data
+	std::uint64_t hash_bytes( std::string_view data, std::uint64_t seed = 0 ) noexcept;
+
+	/// \return A hash of the config_t fields that change what infer_schema finds
+	std::uint64_t hash_inference_config( config_t const &config );
+
+	/// \return A hash of the config_t fields that change what generate_code
+	/// writes for a schema
+	std::uint64_t hash_output_config( config_t const &config );
+
+	/// An on-disk cache of inferred schemas and generated code, keyed by hashes
+	/// of the inputs and the configuration.  Entries that cannot be read are
+	/// treated as missing and failures to write them are ignored, the cache
+	/// only ever saves work
+	class schema_cache_t {
+		std::filesystem::path m_directory;
+
+		std::filesystem::path entry_path( std::uint64_t key, char const *extension ) const;
+		std::optional<std::string> load( std::uint64_t key, char const *extension ) const;
+		void store( std::uint64_t key, char const *extension, std::string_view data ) const;
+
+	public:
+		explicit schema_cache_t( std::filesystem::path directory );
+
+		std::optional<schema_t> load_schema( std::uint64_t key ) const;
+		void store_schema( std::uint64_t key, schema_t const &schema ) const;
+
+		std::optional<std::string> load_output( std::uint64_t key ) const;
+		void store_output( std::uint64_t key, std::string_view output ) const;
+	};
+} // namespace daw::json_to_cpp
@@ -0,0 +1,43 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "json_to_cpp.h"
+
+namespace daw::json_to_cpp {
+	/// Changed whenever the binary form of a schema changes, so that old
+	/// snapshots and cache entries are rejected instead of misread
+	inline constexpr std::uint32_t schema_format_version = 6;
+
+	/// \return A compact binary form of the types of schema.  Strings are
+	/// stored once in a string table and the types in a flat node table, where
+	/// the elements of a type always come after it.  The statistics are not
+	/// kept
+	std::string serialize_schema( schema_t const &schema );
+
+	/// \return The schema stored by serialize_schema, or nothing if data is not
+	/// a schema of the current format version
+	std::optional<schema_t> deserialize_schema( std::string_view data );
+
+	/// Write the serialized form of schema to path
+	/// \throws std::runtime_error if the file cannot be written
+	void save_schema_snapshot( std::filesystem::path const &path, schema_t const &schema );
+
+	/// Read a schema written by save_schema_snapshot.  The result can be
+	/// merged with merge_schema like any inferred schema
+	/// \throws std::runtime_error if the file cannot be read or is not a
+	/// snapshot of the current format version
+	schema_t load_schema_snapshot( std::filesystem::path const &path );
+} // namespace daw::json_to_cpp
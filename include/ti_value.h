@@ -14,7 +14,6 @@
 
 #include <daw/cpp_17.h>
 #include <daw/daw_enable_if.h>
-#include <daw/daw_ordered_map.h>
 #include <daw/daw_poly_var.h>
 #include <daw/daw_visit.h>
 
@@ -57,32 +56,32 @@ namespace daw::json_to_cpp::types {
 			  value, []( auto const &item ) { return item.array_member_info( ); } );
 		}
 
-		inline daw::ordered_map<std::string, ti_types_t> const &children( ) const {
+		inline ti_object::child_t const &children( ) const {
 			return daw::visit_nt(
 			  value,
 			  []( ti_array const &v )
-			    -> daw::ordered_map<std::string, ti_types_t> const & {
+			    -> ti_object::child_t const & {
 				  return *v.children;
 			  },
 			  []( ti_object const &v )
-			    -> daw::ordered_map<std::string, ti_types_t> const & {
+			    -> ti_object::child_t const & {
 				  return *v.children;
 			  },
-			  []( auto ) -> daw::ordered_map<std::string, ti_types_t> const & {
+			  []( auto ) -> ti_object::child_t const & {
 				  std::terminate( );
 			  } );
 		}
 
-		inline daw::ordered_map<std::string, ti_types_t> &children( ) {
+		inline ti_object::child_t &children( ) {
 			return daw::visit_nt(
 			  value,
-			  []( ti_array &v ) -> daw::ordered_map<std::string, ti_types_t> & {
+			  []( ti_array &v ) -> ti_object::child_t & {
 				  return *v.children;
 			  },
-			  []( ti_object &v ) -> daw::ordered_map<std::string, ti_types_t> & {
+			  []( ti_object &v ) -> ti_object::child_t & {
 				  return *v.children;
 			  },
-			  []( auto ) -> daw::ordered_map<std::string, ti_types_t> & {
+			  []( auto ) -> ti_object::child_t & {
 				  std::terminate( );
 			  } );
 		}
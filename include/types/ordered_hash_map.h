@@ -0,0 +1,178 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory_resource>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace daw::json_to_cpp::types {
+	/// A map from std::string_view that iterates in insertion order with
+	/// constant time lookup by key.  Entries are stored contiguously and an open
+	/// addressing table of entry indices is built once the map is large enough to
+	/// benefit from it.  The map does not own the key text, keys must outlive the
+	/// map.  Entries are never removed
+	template<typename Value>
+	class ordered_hash_map {
+	public:
+		using key_type = std::string_view;
+		using value_type = std::pair<key_type, Value>;
+		using iterator = typename std::pmr::vector<value_type>::iterator;
+		using const_iterator = typename std::pmr::vector<value_type>::const_iterator;
+
+	private:
+		// Below this size a linear search is faster than hashing
+		static constexpr std::size_t linear_search_limit = 8;
+		static constexpr std::uint32_t empty_slot = 0;
+
+		std::pmr::vector<value_type> m_values;
+		std::pmr::vector<std::size_t> m_hashes;
+		// Index + 1 into m_values, or empty_slot
+		std::pmr::vector<std::uint32_t> m_slots;
+
+		template<typename K>
+		static key_type as_view( K const &key ) noexcept {
+			return key_type( key.data( ), key.size( ) );
+		}
+
+		static std::size_t hash( key_type key ) noexcept {
+			return std::hash<key_type>{ }( key );
+		}
+
+		void insert_slot( std::size_t idx ) {
+			auto const mask = m_slots.size( ) - 1U;
+			auto pos = m_hashes[idx] & mask;
+			while( m_slots[pos] != empty_slot ) {
+				pos = ( pos + 1U ) & mask;
+			}
+			m_slots[pos] = static_cast<std::uint32_t>( idx + 1U );
+		}
+
+		void rehash( std::size_t slot_count ) {
+			m_slots.assign( slot_count, empty_slot );
+			for( std::size_t n = 0; n < m_values.size( ); ++n ) {
+				insert_slot( n );
+			}
+		}
+
+		std::size_t find_index( key_type key, std::size_t h ) const noexcept {
+			if( m_slots.empty( ) ) {
+				for( std::size_t n = 0; n < m_values.size( ); ++n ) {
+					if( m_hashes[n] == h and m_values[n].first == key ) {
+						return n;
+					}
+				}
+				return m_values.size( );
+			}
+			auto const mask = m_slots.size( ) - 1U;
+			for( auto pos = h & mask; m_slots[pos] != empty_slot; pos = ( pos + 1U ) & mask ) {
+				auto const idx = m_slots[pos] - 1U;
+				if( m_hashes[idx] == h and m_values[idx].first == key ) {
+					return idx;
+				}
+			}
+			return m_values.size( );
+		}
+
+		void append( key_type key, std::size_t h ) {
+			m_values.emplace_back( key, Value{ } );
+			m_hashes.push_back( h );
+			auto const idx = m_values.size( ) - 1U;
+			if( m_slots.empty( ) ) {
+				if( m_values.size( ) > linear_search_limit ) {
+					rehash( 4U * linear_search_limit );
+				}
+			} else if( 2U * m_values.size( ) > m_slots.size( ) ) {
+				// Keep the load factor at or below 0.5
+				rehash( 2U * m_slots.size( ) );
+			} else {
+				insert_slot( idx );
+			}
+		}
+
+	public:
+		explicit ordered_hash_map(
+		  std::pmr::memory_resource *resource = std::pmr::get_default_resource( ) )
+		  : m_values( resource )
+		  , m_hashes( resource )
+		  , m_slots( resource ) {}
+
+		template<typename K>
+		iterator find( K const &key ) {
+			auto const k = as_view( key );
+			return std::next( m_values.begin( ),
+			                  static_cast<std::ptrdiff_t>( find_index( k, hash( k ) ) ) );
+		}
+
+		template<typename K>
+		const_iterator find( K const &key ) const {
+			auto const k = as_view( key );
+			return std::next( m_values.begin( ),
+			                  static_cast<std::ptrdiff_t>( find_index( k, hash( k ) ) ) );
+		}
+
+		template<typename K>
+		bool contains( K const &key ) const {
+			return find( key ) != end( );
+		}
+
+		/// Find key, adding a default constructed value if it is missing
+		/// \return The entry and whether it was added
+		std::pair<iterator, bool> try_emplace( key_type key ) {
+			auto const h = hash( key );
+			auto idx = find_index( key, h );
+			bool const is_new = idx == m_values.size( );
+			if( is_new ) {
+				append( key, h );
+			}
+			return { std::next( m_values.begin( ), static_cast<std::ptrdiff_t>( idx ) ), is_new };
+		}
+
+		Value &operator[]( key_type key ) {
+			return try_emplace( key ).first->second;
+		}
+
+		std::size_t size( ) const noexcept {
+			return m_values.size( );
+		}
+
+		bool empty( ) const noexcept {
+			return m_values.empty( );
+		}
+
+		value_type &front( ) {
+			return m_values.front( );
+		}
+
+		value_type const &front( ) const {
+			return m_values.front( );
+		}
+
+		iterator begin( ) noexcept {
+			return m_values.begin( );
+		}
+
+		iterator end( ) noexcept {
+			return m_values.end( );
+		}
+
+		const_iterator begin( ) const noexcept {
+			return m_values.begin( );
+		}
+
+		const_iterator end( ) const noexcept {
+			return m_values.end( );
+		}
+	};
+} // namespace daw::json_to_cpp::types
@@ -0,0 +1,60 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <string_view>
+#include <unordered_set>
+
+#include "ti_types.h"
+
+namespace daw::json_to_cpp::types {
+	/// Storage for the types of one inference run.  The member maps of the types
+	/// and the names they use are allocated from a monotonic buffer and are
+	/// never destroyed one by one, all of it is released at once with the arena.
+	/// Not thread safe, each worker uses its own arena
+	class ti_arena {
+		std::pmr::monotonic_buffer_resource m_resource;
+		std::pmr::unordered_set<std::string_view> m_names;
+
+	public:
+		ti_arena( );
+
+		ti_arena( ti_arena const & ) = delete;
+		ti_arena &operator=( ti_arena const & ) = delete;
+
+		std::pmr::memory_resource *resource( ) noexcept {
+			return &m_resource;
+		}
+
+		/// \return A copy of name owned by the arena.  Equal names share storage
+		std::string_view intern( std::string_view name );
+
+		/// \return An empty member, element or value map owned by the arena
+		ti_object::child_t *make_children( ) {
+			void *ptr = m_resource.allocate( sizeof( ti_object::child_t ),
+			                                 alignof( ti_object::child_t ) );
+			return ::new( ptr ) ti_object::child_t( &m_resource );
+		}
+
+		/// \return Zeroed member counts owned by the arena
+		member_counts_t *make_member_counts( ) {
+			void *ptr = m_resource.allocate( sizeof( member_counts_t ), alignof( member_counts_t ) );
+			return ::new( ptr ) member_counts_t( &m_resource );
+		}
+
+		/// \return An empty set of string values owned by the arena
+		string_values_t *make_string_values( ) {
+			void *ptr = m_resource.allocate( sizeof( string_values_t ), alignof( string_values_t ) );
+			return ::new( ptr ) string_values_t( &m_resource );
+		}
+	};
+} // namespace daw::json_to_cpp::types
@@ -9,12 +9,14 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <variant>
 
-#include <daw/daw_ordered_map.h>
 #include <daw/daw_string_view.h>
 
+#include "ordered_hash_map.h"
 #include "ti_base.h"
 #include "ti_boolean.h"
 #include "ti_integral.h"
@@ -26,25 +28,53 @@ namespace daw::json_to_cpp::types {
 	struct ti_array;
 	struct ti_object;
 	struct ti_kv;
-	struct ti_array {
+	struct ti_array : impl::counted_copy {
 		using child_items_t =
 		  std::variant<ti_null, ti_array, ti_boolean, ti_integral, ti_object,
 		               ti_real, ti_string, ti_kv>;
 
-		using child_t = daw::ordered_map<std::string, child_items_t>;
+		using child_t = ordered_hash_map<child_items_t>;
 
-		std::unique_ptr<child_t> children;
+		/// The element type, owned by the ti_arena of the schema and shared by
+		/// copies.  Empty until an element has been seen
+		child_t *children = nullptr;
+
+		/// The fewest and most elements of the arrays seen.  min_size is larger
+		/// than max_size until the end of an array has been seen
+		std::uint64_t min_size = std::numeric_limits<std::uint64_t>::max( );
+		std::uint64_t max_size = 0;
+		/// The number of arrays seen.  The length of a single array, such as
+		/// the root of a document, says little about the next one
+		std::uint64_t instances = 0;
+		/// Generate std::array when every array had the same length, up to this
+		/// length.  0 disables it
+		std::uint32_t fixed_size_max = 0;
+		/// Generate a small_vector with inline capacity for max_size elements
+		/// when that is no more than this.  0 disables it
+		std::uint32_t small_size_max = 0;
 
 		bool is_optional = false;
 		static constexpr bool is_null = false;
 		static constexpr size_t type = impl::ti_array_pos;
 
-		ti_array( );
-		ti_array( ti_array && ) noexcept = default;
-		ti_array &operator=( ti_array && ) noexcept = default;
-		~ti_array( ) = default;
-		ti_array( ti_array const &other );
-		ti_array &operator=( ti_array const &rhs );
+		ti_array( ) = default;
+		explicit ti_array( child_t *elements ) noexcept;
+		ti_array( std::uint32_t fixed_max, std::uint32_t small_max ) noexcept;
+
+		/// Count an array of length elements
+		/// \return true if the range of lengths changed
+		bool add_size( std::uint64_t length ) noexcept;
+
+		/// Add the arrays counted by other
+		/// \return true if the range of lengths changed
+		bool merge_sizes( ti_array const &other ) noexcept;
+
+		bool widen_sizes( std::uint64_t min_length, std::uint64_t max_length ) noexcept;
+
+		/// At least two arrays were seen and they all had the same length, which
+		/// is generated as a std::array
+		bool is_fixed_size( ) const noexcept;
+		bool is_small_vector( ) const noexcept;
 
 		std::string name( ) const;
 		std::string json_name( daw::string_view member_name, bool use_cpp20,
@@ -10,6 +10,9 @@
 
 #include <cstddef>
 #include <type_traits>
+#if defined( JSON_TO_CPP_COUNT_COPIES )
+#include <atomic>
+#endif
 #include <variant>
 
 #include <daw/cpp_17.h>
@@ -25,6 +28,31 @@ namespace daw::json_to_cpp::types::impl {
 	inline constexpr size_t ti_string_pos = 6;
 	inline constexpr size_t ti_kv_pos = 7;
 
+#if defined( JSON_TO_CPP_COUNT_COPIES )
+	/// The copies of ti_object, ti_array and ti_kv made so far, counted for
+	/// the benchmarks
+	inline std::atomic<std::size_t> subtree_copy_count{ 0 };
+
+	/// A base of the types with members that counts their copies
+	struct counted_copy {
+		counted_copy( ) = default;
+		counted_copy( counted_copy && ) = default;
+		counted_copy &operator=( counted_copy && ) = default;
+
+		counted_copy( counted_copy const & ) noexcept {
+			subtree_copy_count.fetch_add( 1, std::memory_order_relaxed );
+		}
+
+		counted_copy &operator=( counted_copy const & ) noexcept {
+			subtree_copy_count.fetch_add( 1, std::memory_order_relaxed );
+			return *this;
+		}
+	};
+#else
+	/// Copies are only counted when JSON_TO_CPP_COUNT_COPIES is defined
+	struct counted_copy {};
+#endif
+
 	template<typename Variant, typename T, size_t Pos>
 	inline constexpr bool validate_pos_value_v =
 	  std::is_same_v<daw::remove_cvref_t<decltype( std::get<Pos>( std::declval<Variant>( ) ) )>, T>;
@@ -8,7 +8,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <string>
 
 #include <daw/daw_string_view.h>
@@ -19,26 +22,119 @@
 namespace daw::json_to_cpp::types {
 	struct ti_integral {
 		bool is_optional = false;
+		/// The range of the values seen.  Unless numbers are narrowed it is the
+		/// range of int64_t, which is what is generated
+		std::int64_t min_value = std::numeric_limits<std::int64_t>::min( );
+		std::uint64_t max_value =
+		  static_cast<std::uint64_t>( std::numeric_limits<std::int64_t>::max( ) );
+		/// The generated type holds values margin_bits wider than the range
+		std::uint8_t margin_bits = 0;
 
 		constexpr ti_integral( ) noexcept = default;
 
+		constexpr ti_integral( std::int64_t min, std::uint64_t max, std::uint8_t margin ) noexcept
+		  : min_value( min )
+		  , max_value( max )
+		  , margin_bits( margin ) {}
+
 		static constexpr bool is_null = false;
 		static constexpr size_t type = impl::ti_integral_pos;
 
-		static inline std::string name( ) noexcept {
-			return "int64_t";
+		/// Widen the range to include other's
+		/// \return true if this changed
+		constexpr bool merge( ti_integral const &other ) noexcept {
+			bool changed = false;
+			if( other.min_value < min_value ) {
+				min_value = other.min_value;
+				changed = true;
+			}
+			if( other.max_value > max_value ) {
+				max_value = other.max_value;
+				changed = true;
+			}
+			if( other.margin_bits > margin_bits ) {
+				margin_bits = other.margin_bits;
+				changed = true;
+			}
+			return changed;
+		}
+
+		/// \return true if every value in the range is exact as a float
+		constexpr bool fits_float( ) const noexcept {
+			constexpr std::int64_t float_exact = std::int64_t{ 1 } << std::numeric_limits<float>::digits;
+			return min_value >= -float_exact and max_value <= static_cast<std::uint64_t>( float_exact );
+		}
+
+		/// \return false if the range has negative values and values beyond
+		/// int64_t, no integer type holds both
+		constexpr bool has_integer_type( ) const noexcept {
+			return min_value >= 0 or
+			       max_value <= static_cast<std::uint64_t>( std::numeric_limits<std::int64_t>::max( ) );
+		}
+
+		/// The bits the range and its margin need, the sign bit included
+		constexpr unsigned needed_bits( ) const noexcept {
+			auto const value_bits = []( std::uint64_t value ) {
+				unsigned result = 0;
+				for( ; value != 0; value >>= 1U ) {
+					++result;
+				}
+				return result;
+			};
+			auto bits = value_bits( max_value );
+			if( min_value < 0 ) {
+				// -1 needs no magnitude bits, -128 needs 7
+				bits = std::max( bits, value_bits( ~static_cast<std::uint64_t>( min_value ) ) ) + 1U;
+			}
+			return bits + margin_bits;
+		}
+
+		/// The bits of the generated integer type, 0 if no integer type holds
+		/// the range
+		constexpr unsigned bit_width( ) const noexcept {
+			if( not has_integer_type( ) ) {
+				return 0;
+			}
+			auto const bits = needed_bits( );
+			for( unsigned width = 8; width <= 64; width *= 2 ) {
+				if( bits <= width ) {
+					return width;
+				}
+			}
+			// The margin does not fit, use the widest type that holds the range
+			return 64;
+		}
+
+		/// The size of the generated type in bytes
+		constexpr std::size_t byte_width( ) const noexcept {
+			return has_integer_type( ) ? bit_width( ) / 8U : sizeof( double );
+		}
+
+		/// The narrowest fixed width type that holds the range and its margin.
+		/// A range no integer type holds is generated as a double, which loses
+		/// precision instead of overflowing
+		inline std::string name( ) const {
+			if( not has_integer_type( ) ) {
+				return "double";
+			}
+			bool is_signed = min_value < 0;
+			if( needed_bits( ) > 64 ) {
+				// Without the margin, only a range beyond int64_t needs uint64_t
+				is_signed = max_value <= static_cast<std::uint64_t>( std::numeric_limits<std::int64_t>::max( ) );
+			}
+			return ( is_signed ? "int" : "uint" ) + std::to_string( bit_width( ) ) + "_t";
 		}
 
-		static inline std::string array_member_info( ) noexcept {
-			return "int64_t";
+		inline std::string array_member_info( ) const {
+			return name( );
 		}
 
-		inline static std::string
+		inline std::string
 		json_name( daw::string_view member_name, bool use_cpp20,
-		           daw::string_view parent_name ) noexcept {
+		           daw::string_view parent_name ) const {
 			return "json_number<" +
 			       impl::format_member_name( member_name, use_cpp20, parent_name ) +
-			       ", int64_t>";
+			       ", " + name( ) + ">";
 		}
 	};
 } // namespace daw::json_to_cpp::types
@@ -9,13 +9,13 @@
 #pragma once
 
 #include <cstddef>
-#include <memory>
 #include <string>
+#include <string_view>
 #include <variant>
 
-#include <daw/daw_ordered_map.h>
 #include <daw/json/daw_json_value_t.h>
 
+#include "ordered_hash_map.h"
 #include "ti_base.h"
 #include "ti_boolean.h"
 #include "ti_integral.h"
@@ -27,27 +27,24 @@ namespace daw::json_to_cpp::types {
 	struct ti_array;
 	struct ti_kv;
 	struct ti_object;
-	struct ti_kv {
+	struct ti_kv : impl::counted_copy {
 		using child_items_t =
 		  std::variant<ti_null, ti_array, ti_boolean, ti_integral, ti_object,
 		               ti_real, ti_string, ti_kv>;
 
-		using child_t = daw::ordered_map<std::string, child_items_t>;
+		using child_t = ordered_hash_map<child_items_t>;
 
 		bool is_optional = false;
-		std::unique_ptr<child_t> value;
-		std::string kv_name;
+		/// The value type, owned by the ti_arena of the schema and shared by
+		/// copies.  Empty until a value has been seen
+		child_t *value = nullptr;
+		/// Interned in the ti_arena of the schema
+		std::string_view kv_name;
 
 		static constexpr bool is_null = false;
 		static constexpr size_t type = impl::ti_kv_pos;
 
-		explicit ti_kv( std::string obj_name );
-		ti_kv( ti_kv const &other );
-		ti_kv &operator=( ti_kv const &rhs );
-
-		ti_kv( ti_kv && ) noexcept = default;
-		ti_kv &operator=( ti_kv && ) noexcept = default;
-		~ti_kv( ) = default;
+		ti_kv( std::string_view obj_name, child_t *values ) noexcept;
 
 		std::string name( ) const;
 		std::string array_member_info( ) const;
@@ -9,12 +9,15 @@
 #pragma once
 
 #include <cstddef>
-#include <memory>
+#include <cstdint>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <vector>
 
-#include <daw/daw_ordered_map.h>
 #include <daw/json/daw_json_value_t.h>
 
+#include "ordered_hash_map.h"
 #include "ti_base.h"
 #include "ti_boolean.h"
 #include "ti_integral.h"
@@ -26,26 +29,50 @@ namespace daw::json_to_cpp::types {
 	struct ti_array;
 	struct ti_object;
 	struct ti_kv;
-	struct ti_object {
+
+	/// How many instances of an object were seen and how many of them had each
+	/// member.  Owned by the ti_arena of the schema
+	struct member_counts_t {
+		std::uint64_t instances = 0;
+		/// In the order of the members, members past the end were not counted
+		std::pmr::vector<std::uint64_t> present;
+
+		explicit member_counts_t( std::pmr::memory_resource *resource )
+		  : present( resource ) {}
+
+		std::uint64_t present_count( std::size_t member ) const noexcept {
+			return member < present.size( ) ? present[member] : 0U;
+		}
+
+		void add_present( std::size_t member, std::uint64_t count ) {
+			if( member >= present.size( ) ) {
+				present.resize( member + 1U, 0U );
+			}
+			present[member] += count;
+		}
+	};
+
+	struct ti_object : impl::counted_copy {
 		using child_items_t =
 		  std::variant<ti_null, ti_array, ti_boolean, ti_integral, ti_object,
 		               ti_real, ti_string, ti_kv>;
-		using child_t = daw::ordered_map<std::string, child_items_t>;
+		using child_t = ordered_hash_map<child_items_t>;
 
-		std::unique_ptr<child_t> children;
+		/// Owned by the ti_arena of the schema.  Copies share the members, only
+		/// the object held by the object registry is changed and every other copy
+		/// is only used for its name
+		child_t *children = nullptr;
+		/// Shared like children, null if the counts are not known
+		member_counts_t *counts = nullptr;
 
 		bool is_optional = false;
-		std::string object_name;
+		/// Interned in the ti_arena of the schema
+		std::string_view object_name;
 
 		static constexpr bool is_null = false;
 		static constexpr size_t type = impl::ti_object_pos;
 
-		explicit ti_object( std::string obj_name );
-		ti_object( ti_object && ) noexcept = default;
-		ti_object &operator=( ti_object && ) noexcept = default;
-		~ti_object( ) = default;
-		ti_object( ti_object const &other );
-		ti_object &operator=( ti_object const &rhs );
+		ti_object( std::string_view obj_name, child_t *members ) noexcept;
 
 		std::string name( ) const;
 		std::string json_name( daw::string_view member_name, bool use_cpp20,
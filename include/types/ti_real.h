@@ -19,23 +19,42 @@
 namespace daw::json_to_cpp::types {
 	struct ti_real {
 		bool is_optional = false;
+		/// Every value seen was exact as a float.  Only set when numbers are
+		/// narrowed
+		bool is_float = false;
 
 		static constexpr bool is_null = false;
 		static constexpr size_t type = impl::ti_real_pos;
 
 		constexpr ti_real( ) noexcept = default;
 
-		static inline std::string name( ) noexcept {
-			return "double";
+		constexpr explicit ti_real( bool value_is_float ) noexcept
+		  : is_float( value_is_float ) {}
+
+		/// The size of the generated type in bytes
+		constexpr std::size_t byte_width( ) const noexcept {
+			return is_float ? sizeof( float ) : sizeof( double );
 		}
 
-		static inline std::string array_member_info( ) noexcept {
+		inline std::string name( ) const {
+			if( is_float ) {
+				return "float";
+			}
 			return "double";
 		}
 
-		inline static std::string
+		inline std::string array_member_info( ) const {
+			return name( );
+		}
+
+		inline std::string
 		json_name( daw::string_view member_name, bool use_cpp20,
-		           daw::string_view parent_name ) noexcept {
+		           daw::string_view parent_name ) const {
+			if( is_float ) {
+				return "json_number<" +
+				       impl::format_member_name( member_name, use_cpp20, parent_name ) +
+				       ", float>";
+			}
 			return "json_number<" +
 			       impl::format_member_name( member_name, use_cpp20, parent_name ) +
 			       ">";
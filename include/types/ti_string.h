@@ -9,7 +9,11 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <daw/daw_string_view.h>
 #include <daw/json/daw_json_value_t.h>
@@ -17,18 +21,117 @@
 #include "ti_base.h"
 
 namespace daw::json_to_cpp::types {
+	/// The distinct values of a string, as long as there are few of them.  Owned
+	/// by the ti_arena of the schema and shared by copies of the type
+	struct string_values_t {
+		/// In the order they were first seen
+		std::pmr::vector<std::string_view> values;
+		/// The number of values seen, including repeats
+		std::uint64_t count = 0;
+		/// There were too many distinct values, or one that cannot be an
+		/// enumerator, values is no longer kept
+		bool is_overflow = false;
+
+		/// At most this many distinct values are kept
+		std::size_t max_values = 0;
+
+		explicit string_values_t( std::pmr::memory_resource *resource )
+		  : values( resource ) {}
+
+		bool contains( std::string_view value ) const noexcept {
+			for( auto const &v : values ) {
+				if( v == value ) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void set_overflow( ) noexcept {
+			is_overflow = true;
+			values.clear( );
+		}
+
+		/// Add a value that is not known yet.  The storage of value must live as
+		/// long as the schema
+		/// \return false if that was one value too many
+		bool insert( std::string_view value ) {
+			if( values.size( ) >= max_values ) {
+				set_overflow( );
+				return false;
+			}
+			values.push_back( value );
+			return true;
+		}
+
+		/// Add the values of other
+		/// \return true if the values changed
+		bool merge( string_values_t const &other ) {
+			if( &other == this ) {
+				return false;
+			}
+			count += other.count;
+			if( is_overflow ) {
+				return false;
+			}
+			if( other.is_overflow ) {
+				set_overflow( );
+				return true;
+			}
+			bool changed = false;
+			for( auto const &value : other.values ) {
+				if( not contains( value ) ) {
+					changed = true;
+					if( not insert( value ) ) {
+						break;
+					}
+				}
+			}
+			return changed;
+		}
+	};
+
 	class ti_string {
 		bool m_use_string_view;
 
 	public:
 		bool is_optional = false;
+		/// The values seen, null unless enums are inferred
+		string_values_t *values = nullptr;
+		/// The name of the enum, without the _t, when values is set
+		std::string_view enum_stem{ };
+
 		static constexpr bool is_null = false;
 		static constexpr size_t type = impl::ti_string_pos;
 
 		constexpr explicit ti_string( bool use_string_view ) noexcept
 		  : m_use_string_view( use_string_view ) {}
 
+		constexpr bool use_string_view( ) const noexcept {
+			return m_use_string_view;
+		}
+
+		/// An enum is generated when every value seen fit and each distinct
+		/// value was seen twice on average, so that a member only seen a few
+		/// times does not become an enum of those few values
+		bool is_enum( ) const noexcept {
+			return values != nullptr and not values->is_overflow and not values->values.empty( ) and
+			       values->count >= 2U * values->values.size( );
+		}
+
+		inline std::string enum_name( ) const {
+			return std::string( enum_stem ) + "_t";
+		}
+
+		/// The converter that maps the enum to and from its JSON strings
+		inline std::string converter_name( ) const {
+			return std::string( enum_stem ) + "_converter_t";
+		}
+
 		inline std::string name( ) const noexcept {
+			if( is_enum( ) ) {
+				return enum_name( );
+			}
 			if( m_use_string_view ) {
 				return "std::string_view";
 			}
@@ -36,6 +139,10 @@ namespace daw::json_to_cpp::types {
 		}
 
 		inline std::string array_member_info( ) const noexcept {
+			if( is_enum( ) ) {
+				return "json_custom_no_name<" + enum_name( ) + ", " + converter_name( ) + ", " +
+				       converter_name( ) + ">";
+			}
 			if( m_use_string_view ) {
 				return "json_string<no_name, std::string_view>";
 			}
@@ -45,6 +152,11 @@ namespace daw::json_to_cpp::types {
 		inline std::string
 		json_name( daw::string_view member_name, bool use_cpp20,
 		           daw::string_view parent_name ) const noexcept {
+			if( is_enum( ) ) {
+				return "json_custom<" +
+				       impl::format_member_name( member_name, use_cpp20, parent_name ) + ", " +
+				       enum_name( ) + ", " + converter_name( ) + ", " + converter_name( ) + ">";
+			}
 			if( m_use_string_view ) {
 				return "json_string<" +
 				       impl::format_member_name( member_name, use_cpp20, parent_name ) +
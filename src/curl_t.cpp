@@ -6,11 +6,15 @@
 // Official repository: https://github.com/beached/daw_json_link
 //
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <curl/curl.h>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include <daw/daw_string_view.h>
 
@@ -18,11 +22,13 @@
 
 namespace daw::curl {
 	namespace {
-		size_t callback( char const *in, size_t const size, size_t const num,
-		                 std::string *const out ) {
+		size_t stream_callback( char const *in, size_t const size, size_t const num,
+		                        body_stream_t *const out ) {
 			assert( out );
 			size_t const totalBytes = size * num;
-			out->append( in, totalBytes );
+			if( not out->write( daw::string_view( in, totalBytes ) ) ) {
+				return CURL_WRITEFUNC_PAUSE;
+			}
 			return totalBytes;
 		}
 
@@ -51,14 +57,8 @@ namespace daw::curl {
 				                         std::forward<Param>( param ) );
 			}
 
-			CURLcode perform( ) {
-				return curl_easy_perform( m_curl );
-			}
-
-			template<typename Info, typename Arg>
-			CURLcode getinfo( Info &&info, Arg &&arg ) {
-				return curl_easy_getinfo( m_curl, std::forward<Info>( info ),
-				                          std::forward<Arg>( arg ) );
+			CURLcode unpause( ) {
+				return curl_easy_pause( m_curl, CURLPAUSE_CONT );
 			}
 		};
 
@@ -84,55 +84,295 @@ namespace daw::curl {
 				m_headers = curl_slist_append( m_headers, str );
 			}
 		};
+		struct multi_t {
+			CURLM *m_multi;
+
+			multi_t( )
+			  : m_multi( curl_multi_init( ) ) {}
+
+			~multi_t( ) {
+				curl_multi_cleanup( std::exchange( m_multi, nullptr ) );
+			}
+
+			multi_t( multi_t const & ) = delete;
+			multi_t( multi_t && ) = delete;
+			multi_t &operator=( multi_t const & ) = delete;
+			multi_t &operator=( multi_t && ) = delete;
+
+			explicit operator bool( ) const noexcept {
+				return static_cast<bool>( m_multi );
+			}
+
+			template<typename Opt, typename Param>
+			CURLMcode setopt( Opt &&opt, Param &&param ) {
+				return curl_multi_setopt( m_multi, std::forward<Opt>( opt ),
+				                          std::forward<Param>( param ) );
+			}
+
+			CURLMcode add( curl_t &curl ) {
+				return curl_multi_add_handle( m_multi, curl.m_curl );
+			}
+
+			CURLMcode remove( curl_t &curl ) {
+				return curl_multi_remove_handle( m_multi, curl.m_curl );
+			}
+		};
+
+		void add_json_headers( slist_t &headers ) {
+			headers.append( "Accept: application/json" );
+			headers.append( "Content-Type: application/json" );
+			headers.append( "charsets: utf-8" );
+		}
+
+		/// The options shared by every GET, the URL and where the body goes are
+		/// set per transfer
+		void set_get_options( curl_t &curl, slist_t &headers, daw::string_view user_agent ) {
+			curl.setopt( CURLOPT_HTTPHEADER, headers.get( ) );
+			curl.setopt( CURLOPT_HTTPGET, 1 );
+			curl.setopt( CURLOPT_USERAGENT, user_agent.data( ) );
+
+			// Don't wait forever.  The bodies are read while they arrive and a
+			// slow reader pauses the transfer, so a limit on the whole transfer
+			// would fail healthy downloads.  Instead a transfer fails when it
+			// cannot connect, or receives less than 1 byte a second for 15
+			// seconds while it is not paused
+			curl.setopt( CURLOPT_CONNECTTIMEOUT, 15L );
+			curl.setopt( CURLOPT_LOW_SPEED_LIMIT, 1L );
+			curl.setopt( CURLOPT_LOW_SPEED_TIME, 15L );
+
+			// Follow HTTP redirects if necessary.
+			curl.setopt( CURLOPT_FOLLOWLOCATION, 1L );
+
+			// Hook up data handling function.
+			curl.setopt( CURLOPT_WRITEFUNCTION, stream_callback );
+		}
+
+		/// One transfer slot of download_all.  The easy handle is reused for
+		/// each url given to the slot, keeping its connection open
+		struct transfer_t {
+			curl_t curl{ };
+			body_stream_t *stream = nullptr;
+			std::size_t index = 0;
+			bool is_active = false;
+		};
 	} // namespace
 
-	std::optional<std::string> download( daw::string_view url,
-	                                     daw::string_view user_agent ) {
-		auto headers = slist_t( );
-		headers.append( "Accept: application/json" );
-		headers.append( "Content-Type: application/json" );
-		headers.append( "charsets: utf-8" );
+	body_stream_t::body_stream_t( std::size_t capacity )
+	  : m_capacity( capacity ) {}
+
+	daw::string_view body_stream_t::read( ) {
+		auto lck = std::unique_lock<std::mutex>( m_lock );
+		m_reading.clear( );
+		m_changed.wait( lck, [&] { return not m_filling.empty( ) or m_finished; } );
+		// Swapping keeps both buffers allocated, and m_reading stays valid
+		// while download_all writes the next part to m_filling
+		std::swap( m_filling, m_reading );
+		bool const is_paused = m_paused;
+		auto *const multi = m_multi;
+		lck.unlock( );
+		if( is_paused ) {
+			curl_multi_wakeup( multi );
+		}
+		return daw::string_view( m_reading.data( ), m_reading.size( ) );
+	}
 
-		auto curl = curl_t( );
-		if( not curl ) {
+	std::optional<std::string> body_stream_t::read_all( ) {
+		auto lck = std::unique_lock<std::mutex>( m_lock );
+		m_changed.wait( lck, [&] { return m_finished; } );
+		if( not m_is_ok ) {
 			return std::nullopt;
 		}
-		curl.setopt( CURLOPT_HTTPHEADER, headers.get( ) );
-		curl.setopt( CURLOPT_HTTPGET, 1 );
-		curl.setopt( CURLOPT_HTTPHEADER, headers.get( ) );
-		curl.setopt( CURLOPT_USERAGENT, user_agent.data( ) );
+		return std::move( m_filling );
+	}
+
+	bool body_stream_t::is_ok( ) {
+		auto const lck = std::lock_guard<std::mutex>( m_lock );
+		return m_is_ok;
+	}
+
+	void body_stream_t::close( ) {
+		auto lck = std::unique_lock<std::mutex>( m_lock );
+		m_closed = true;
+		m_filling = std::string( );
+		bool const is_paused = m_paused;
+		auto *const multi = m_multi;
+		lck.unlock( );
+		if( is_paused ) {
+			curl_multi_wakeup( multi );
+		}
+	}
 
-		// Set remote URL.
-		curl.setopt( CURLOPT_URL, url.data( ) );
+	void body_stream_t::attach( void *multi ) {
+		auto const lck = std::lock_guard<std::mutex>( m_lock );
+		m_multi = multi;
+	}
 
-		// Don't wait forever, time out after 10 seconds.
-		curl.setopt( CURLOPT_TIMEOUT, 15 );
+	bool body_stream_t::write( daw::string_view data ) {
+		auto const lck = std::lock_guard<std::mutex>( m_lock );
+		if( m_closed ) {
+			return true;
+		}
+		// A part larger than the capacity is still taken when nothing is
+		// waiting, so that the transfer always progresses
+		if( not m_filling.empty( ) and
+		    ( m_filling.size( ) >= m_capacity or data.size( ) > m_capacity - m_filling.size( ) ) ) {
+			m_paused = true;
+			return false;
+		}
+		m_filling.append( data.data( ), data.size( ) );
+		m_changed.notify_one( );
+		return true;
+	}
 
-		// Follow HTTP redirects if necessary.
-		curl.setopt( CURLOPT_FOLLOWLOCATION, 1L );
+	bool body_stream_t::resume( ) {
+		auto const lck = std::lock_guard<std::mutex>( m_lock );
+		if( m_paused and ( m_filling.empty( ) or m_closed ) ) {
+			m_paused = false;
+			return true;
+		}
+		return false;
+	}
 
-		// Response information.
-		int httpCode = 0;
-		auto httpData = std::string( );
+	void body_stream_t::finish( bool is_ok ) {
+		auto const lck = std::lock_guard<std::mutex>( m_lock );
+		m_finished = true;
+		m_is_ok = is_ok;
+		m_changed.notify_all( );
+	}
 
-		// Hook up data handling function.
-		curl.setopt( CURLOPT_WRITEFUNCTION, callback );
+	void global_init( ) {
+		static bool const is_init = curl_global_init( CURL_GLOBAL_DEFAULT ) == CURLE_OK;
+		(void)is_init;
+	}
 
-		// Hook up data container ( will be passed as the last parameter to the
-		// callback handling function ).  Can be any pointer type, since it will
-		// internally be passed as a void pointer.
-		curl.setopt( CURLOPT_WRITEDATA, &httpData );
+	void download_all( std::vector<std::string> const &urls,
+	                   daw::string_view user_agent,
+	                   std::size_t max_connections,
+	                   stream_for_t const &stream_for,
+	                   std::atomic<bool> const *cancelled ) {
+		auto headers = slist_t( );
+		add_json_headers( headers );
 
-		// Run our HTTP GET command, capture the HTTP response code, and clean up.
-		curl.perform( );
-		curl.getinfo( CURLINFO_RESPONSE_CODE, &httpCode );
+		max_connections = std::max<std::size_t>( max_connections, 1U );
+		auto multi = multi_t( );
+		if( multi ) {
+			multi.setopt( CURLMOPT_MAX_TOTAL_CONNECTIONS, static_cast<long>( max_connections ) );
+			multi.setopt( CURLMOPT_MAXCONNECTS, static_cast<long>( max_connections ) );
+			// HTTP/2 servers get all the transfers on one connection
+			multi.setopt( CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX );
+		}
 
-		if( httpCode != 200 ) {
-			std::cerr << "Couldn't GET from " << url << '\n';
-			return std::nullopt;
+		auto transfers = std::vector<std::unique_ptr<transfer_t>>( );
+		std::size_t next_url = 0;
+		std::size_t active = 0;
+		auto const start = [&]( transfer_t &transfer ) {
+			transfer.index = next_url++;
+			transfer.stream = &stream_for( transfer.index );
+			transfer.stream->attach( multi.m_multi );
+			transfer.curl.setopt( CURLOPT_URL, urls[transfer.index].c_str( ) );
+			transfer.curl.setopt( CURLOPT_WRITEDATA, transfer.stream );
+			transfer.curl.setopt( CURLOPT_PRIVATE, &transfer );
+			// Still active on failure so that fail_unfinished reports it
+			transfer.is_active = true;
+			if( multi.add( transfer.curl ) != CURLM_OK ) {
+				return false;
+			}
+			++active;
+			return true;
+		};
+		auto const stop_all = [&]( ) {
+			for( auto &transfer : transfers ) {
+				if( std::exchange( transfer->is_active, false ) ) {
+					multi.remove( transfer->curl );
+					transfer->stream->finish( false );
+				}
+			}
+		};
+		// Every url gets a finished stream, even when curl itself fails
+		auto const fail_unfinished = [&]( ) {
+			for( auto &transfer : transfers ) {
+				if( transfer->is_active ) {
+					std::cerr << "Couldn't GET from " << urls[transfer->index] << '\n';
+				}
+			}
+			stop_all( );
+			for( ; next_url < urls.size( ); ++next_url ) {
+				std::cerr << "Couldn't GET from " << urls[next_url] << '\n';
+				stream_for( next_url ).finish( false );
+			}
+		};
+		auto const is_cancelled = [&]( ) {
+			return cancelled != nullptr and cancelled->load( std::memory_order_relaxed );
+		};
+
+		if( not multi ) {
+			fail_unfinished( );
+			return;
+		}
+		auto const slot_count = std::min( max_connections, urls.size( ) );
+		for( std::size_t n = 0; n < slot_count; ++n ) {
+			auto &transfer = *transfers.emplace_back( std::make_unique<transfer_t>( ) );
+			if( not transfer.curl ) {
+				fail_unfinished( );
+				return;
+			}
+			set_get_options( transfer.curl, headers, user_agent );
+			// The body is parsed as it arrives, so an error page must not be
+			// written at all
+			transfer.curl.setopt( CURLOPT_FAILONERROR, 1L );
+			if( not start( transfer ) ) {
+				fail_unfinished( );
+				return;
+			}
 		}
 
-		return { std::move( httpData ) };
+		while( active > 0 ) {
+			if( is_cancelled( ) ) {
+				stop_all( );
+				return;
+			}
+			// Transfers paused by a full stream continue once it has been read
+			for( auto &transfer : transfers ) {
+				if( transfer->is_active and transfer->stream->resume( ) ) {
+					transfer->curl.unpause( );
+				}
+			}
+			int running = 0;
+			if( curl_multi_perform( multi.m_multi, &running ) != CURLM_OK ) {
+				fail_unfinished( );
+				return;
+			}
+			int queued = 0;
+			while( CURLMsg *msg = curl_multi_info_read( multi.m_multi, &queued ) ) {
+				if( msg->msg != CURLMSG_DONE ) {
+					continue;
+				}
+				transfer_t *transfer = nullptr;
+				curl_easy_getinfo( msg->easy_handle, CURLINFO_PRIVATE, &transfer );
+				long http_code = 0;
+				curl_easy_getinfo( msg->easy_handle, CURLINFO_RESPONSE_CODE, &http_code );
+				bool const is_ok = msg->data.result == CURLE_OK and http_code == 200;
+				multi.remove( transfer->curl );
+				transfer->is_active = false;
+				--active;
+				if( not is_ok ) {
+					std::cerr << "Couldn't GET from " << urls[transfer->index] << '\n';
+				}
+				transfer->stream->finish( is_ok );
+				// The handle keeps its connection, so the next url to the same host
+				// does not connect again
+				if( next_url < urls.size( ) and not is_cancelled( ) and not start( *transfer ) ) {
+					fail_unfinished( );
+					return;
+				}
+			}
+			// Readers wake the poll when a paused transfer can continue, the
+			// timeout is short enough to notice cancelled soon
+			if( active > 0 and curl_multi_poll( multi.m_multi, nullptr, 0, 100, nullptr ) != CURLM_OK ) {
+				fail_unfinished( );
+				return;
+			}
+		}
 	}
 
 	bool is_url( daw::string_view path ) {
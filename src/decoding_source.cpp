@@ -0,0 +1,334 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <daw/daw_string_view.h>
+
+#if defined( JSON_TO_CPP_HAS_ZLIB )
+#include <zlib.h>
+#endif
+#if defined( JSON_TO_CPP_HAS_ZSTD )
+#include <zstd.h>
+#endif
+#if defined( JSON_TO_CPP_HAS_LZMA )
+#include <lzma.h>
+#endif
+
+#include "decoding_source.h"
+
+namespace daw::json_to_cpp {
+	namespace {
+		constexpr std::size_t decoded_chunk_size = 64U * 1024U;
+		// Long enough for the longest magic number
+		constexpr std::size_t detect_size = 6;
+
+		constexpr unsigned char gzip_magic[] = { 0x1F, 0x8B };
+		constexpr unsigned char zstd_magic[] = { 0x28, 0xB5, 0x2F, 0xFD };
+		constexpr unsigned char xz_magic[] = { 0xFD, 0x37, 0x7A, 0x58, 0x5A, 0x00 };
+
+		template<std::size_t N>
+		bool starts_with( daw::string_view data, unsigned char const ( &magic )[N] ) noexcept {
+			return data.size( ) >= N and std::memcmp( data.data( ), magic, N ) == 0;
+		}
+
+		char const *compression_name( compression_t format ) noexcept {
+			switch( format ) {
+			case compression_t::gzip:
+				return "gzip";
+			case compression_t::zstd:
+				return "zstd";
+			case compression_t::xz:
+				return "xz";
+			case compression_t::none:
+				break;
+			}
+			return "uncompressed";
+		}
+
+		/// Reads enough of source to detect its format, then returns what was
+		/// read followed by the rest of source
+		class prefixed_source final : public json_source {
+			json_source *m_source;
+			daw::string_view m_prefix{ };
+			// Only used when the first chunk is too short to detect the format
+			std::string m_buffer{ };
+			bool m_prefix_pending = true;
+
+		public:
+			explicit prefixed_source( json_source &source )
+			  : m_source( &source )
+			  , m_prefix( source.next_chunk( ) ) {
+				// The first chunk stays valid until source is read again, so it is
+				// only copied when more is needed, e.g. from a slow pipe
+				if( m_prefix.empty( ) or m_prefix.size( ) >= detect_size ) {
+					return;
+				}
+				m_buffer.assign( m_prefix.data( ), m_prefix.size( ) );
+				while( m_buffer.size( ) < detect_size ) {
+					auto const chunk = source.next_chunk( );
+					if( chunk.empty( ) ) {
+						break;
+					}
+					m_buffer.append( chunk.data( ), chunk.size( ) );
+				}
+				m_prefix = daw::string_view( m_buffer.data( ), m_buffer.size( ) );
+			}
+
+			daw::string_view prefix( ) const noexcept {
+				return m_prefix;
+			}
+
+			daw::string_view next_chunk( ) override {
+				if( m_prefix_pending ) {
+					m_prefix_pending = false;
+					if( not m_prefix.empty( ) ) {
+						return m_prefix;
+					}
+				}
+				return m_source->next_chunk( );
+			}
+		};
+
+		/// The state shared by the decoders, the compressed input and a buffer
+		/// for the decoded output
+		class decoder_base : public json_source {
+		protected:
+			json_source *m_source;
+			daw::string_view m_input{ };
+			bool m_input_ended = false;
+			std::vector<char> m_output;
+			// A decoder can hold more output after filling the buffer, even once
+			// the input has ended
+			bool m_output_full = false;
+
+			/// Make sure there is input unless the source has ended
+			void fill_input( ) {
+				while( m_input.empty( ) and not m_input_ended ) {
+					m_input = m_source->next_chunk( );
+					m_input_ended = m_input.empty( );
+				}
+			}
+
+			[[noreturn]] static void corrupt( compression_t format ) {
+				throw std::runtime_error( std::string( "Corrupt or truncated " ) +
+				                          compression_name( format ) + " input" );
+			}
+
+		public:
+			explicit decoder_base( json_source &source )
+			  : m_source( &source )
+			  , m_output( decoded_chunk_size ) {}
+		};
+
+#if defined( JSON_TO_CPP_HAS_ZLIB )
+		class gzip_decoder final : public decoder_base {
+			::z_stream m_stream{ };
+			bool m_stream_ended = false;
+
+		public:
+			explicit gzip_decoder( json_source &source )
+			  : decoder_base( source ) {
+				// 32 detects the gzip or zlib header
+				if( ::inflateInit2( &m_stream, 15 + 32 ) != Z_OK ) {
+					throw std::runtime_error( "Could not start gzip decoding" );
+				}
+			}
+
+			~gzip_decoder( ) override {
+				::inflateEnd( &m_stream );
+			}
+
+			daw::string_view next_chunk( ) override {
+				while( true ) {
+					fill_input( );
+					if( m_stream_ended ) {
+						if( m_input.empty( ) ) {
+							return { };
+						}
+						// Concatenated gzip members decode as one stream, like gunzip
+						::inflateReset( &m_stream );
+						m_stream_ended = false;
+					}
+					if( m_input.empty( ) and not m_output_full ) {
+						corrupt( compression_t::gzip );
+					}
+					// avail_in is 32 bits, a large mapped file is decoded in parts
+					auto const input_size =
+					  std::min<std::size_t>( m_input.size( ), std::numeric_limits<::uInt>::max( ) );
+					m_stream.next_in = reinterpret_cast<::Bytef *>( const_cast<char *>( m_input.data( ) ) );
+					m_stream.avail_in = static_cast<::uInt>( input_size );
+					m_stream.next_out = reinterpret_cast<::Bytef *>( m_output.data( ) );
+					m_stream.avail_out = static_cast<::uInt>( m_output.size( ) );
+					auto const status = ::inflate( &m_stream, Z_NO_FLUSH );
+					auto const consumed = input_size - m_stream.avail_in;
+					auto const decoded = m_output.size( ) - m_stream.avail_out;
+					m_input.remove_prefix( consumed );
+					m_output_full = m_stream.avail_out == 0;
+					if( status == Z_STREAM_END ) {
+						m_stream_ended = true;
+					} else if( ( status != Z_OK and status != Z_BUF_ERROR ) or ( consumed == 0 and decoded == 0 ) ) {
+						corrupt( compression_t::gzip );
+					}
+					if( decoded > 0 ) {
+						return daw::string_view( m_output.data( ), decoded );
+					}
+				}
+			}
+		};
+#endif
+
+#if defined( JSON_TO_CPP_HAS_ZSTD )
+		class zstd_decoder final : public decoder_base {
+			::ZSTD_DStream *m_stream;
+			// 0 once a frame is complete
+			std::size_t m_frame_remaining = 0;
+
+		public:
+			explicit zstd_decoder( json_source &source )
+			  : decoder_base( source )
+			  , m_stream( ::ZSTD_createDStream( ) ) {
+				if( m_stream == nullptr ) {
+					throw std::runtime_error( "Could not start zstd decoding" );
+				}
+			}
+
+			~zstd_decoder( ) override {
+				::ZSTD_freeDStream( m_stream );
+			}
+
+			daw::string_view next_chunk( ) override {
+				while( true ) {
+					fill_input( );
+					if( m_input.empty( ) and not m_output_full ) {
+						if( m_frame_remaining != 0 ) {
+							corrupt( compression_t::zstd );
+						}
+						return { };
+					}
+					auto in = ::ZSTD_inBuffer{ m_input.data( ), m_input.size( ), 0 };
+					auto out = ::ZSTD_outBuffer{ m_output.data( ), m_output.size( ), 0 };
+					// Consecutive frames are decoded one after the other
+					m_frame_remaining = ::ZSTD_decompressStream( m_stream, &out, &in );
+					if( ::ZSTD_isError( m_frame_remaining ) ) {
+						corrupt( compression_t::zstd );
+					}
+					m_input.remove_prefix( in.pos );
+					m_output_full = out.pos == out.size;
+					if( out.pos > 0 ) {
+						return daw::string_view( m_output.data( ), out.pos );
+					}
+				}
+			}
+		};
+#endif
+
+#if defined( JSON_TO_CPP_HAS_LZMA )
+		class xz_decoder final : public decoder_base {
+			::lzma_stream m_stream = LZMA_STREAM_INIT;
+			bool m_stream_ended = false;
+
+		public:
+			explicit xz_decoder( json_source &source )
+			  : decoder_base( source ) {
+				if( ::lzma_stream_decoder( &m_stream, UINT64_MAX, LZMA_CONCATENATED ) != LZMA_OK ) {
+					throw std::runtime_error( "Could not start xz decoding" );
+				}
+			}
+
+			~xz_decoder( ) override {
+				::lzma_end( &m_stream );
+			}
+
+			daw::string_view next_chunk( ) override {
+				while( not m_stream_ended ) {
+					fill_input( );
+					m_stream.next_in = reinterpret_cast<std::uint8_t const *>( m_input.data( ) );
+					m_stream.avail_in = m_input.size( );
+					m_stream.next_out = reinterpret_cast<std::uint8_t *>( m_output.data( ) );
+					m_stream.avail_out = m_output.size( );
+					// With LZMA_CONCATENATED the end of the input must be signalled
+					auto const status = ::lzma_code( &m_stream, m_input_ended ? LZMA_FINISH : LZMA_RUN );
+					m_input.remove_prefix( m_input.size( ) - m_stream.avail_in );
+					if( status == LZMA_STREAM_END ) {
+						m_stream_ended = true;
+					} else if( status != LZMA_OK or ( m_input_ended and m_stream.avail_out != 0 ) ) {
+						corrupt( compression_t::xz );
+					}
+					auto const decoded = m_output.size( ) - m_stream.avail_out;
+					if( decoded > 0 ) {
+						return daw::string_view( m_output.data( ), decoded );
+					}
+				}
+				return { };
+			}
+		};
+#endif
+
+		std::unique_ptr<json_source> make_decoder( compression_t format, json_source &source ) {
+			switch( format ) {
+#if defined( JSON_TO_CPP_HAS_ZLIB )
+			case compression_t::gzip:
+				return std::make_unique<gzip_decoder>( source );
+#endif
+#if defined( JSON_TO_CPP_HAS_ZSTD )
+			case compression_t::zstd:
+				return std::make_unique<zstd_decoder>( source );
+#endif
+#if defined( JSON_TO_CPP_HAS_LZMA )
+			case compression_t::xz:
+				return std::make_unique<xz_decoder>( source );
+#endif
+			default:
+				break;
+			}
+			throw std::runtime_error( std::string( "This build cannot read " ) +
+			                          compression_name( format ) + " compressed input" );
+		}
+	} // namespace
+
+	compression_t detect_compression( daw::string_view data ) noexcept {
+		if( starts_with( data, gzip_magic ) ) {
+			return compression_t::gzip;
+		}
+		if( starts_with( data, zstd_magic ) ) {
+			return compression_t::zstd;
+		}
+		if( starts_with( data, xz_magic ) ) {
+			return compression_t::xz;
+		}
+		return compression_t::none;
+	}
+
+	decoding_source::decoding_source( json_source &source ) {
+		auto raw = std::make_unique<prefixed_source>( source );
+		m_compression = detect_compression( raw->prefix( ) );
+		m_raw = std::move( raw );
+		if( m_compression != compression_t::none ) {
+			m_decoder = make_decoder( m_compression, *m_raw );
+		}
+	}
+
+	decoding_source::~decoding_source( ) = default;
+
+	daw::string_view decoding_source::next_chunk( ) {
+		if( m_decoder ) {
+			return m_decoder->next_chunk( );
+		}
+		return m_raw->next_chunk( );
+	}
+} // namespace daw::json_to_cpp
@@ -0,0 +1,376 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#include <cstddef>
+#include <string>
+
+#include <daw/daw_string_view.h>
+
+#include "json_events.h"
+#include "json_source.h"
+
+namespace daw::json_to_cpp {
+	namespace {
+		constexpr bool is_ws( char c ) noexcept {
+			return ( c == ' ' ) | ( c == '\t' ) | ( c == '\n' ) | ( c == '\r' );
+		}
+
+		constexpr bool is_number_char( char c ) noexcept {
+			return ( c >= '0' and c <= '9' ) | ( c == '-' ) | ( c == '+' ) | ( c == '.' ) |
+			       ( c == 'e' ) | ( c == 'E' );
+		}
+
+		constexpr bool is_digit( char c ) noexcept {
+			return c >= '0' and c <= '9';
+		}
+
+		/// \return true if number follows the JSON grammar
+		/// -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+		bool is_valid_number( daw::string_view number ) noexcept {
+			std::size_t n = 0;
+			auto const digits = [&] {
+				auto const first = n;
+				while( n < number.size( ) and is_digit( number[n] ) ) {
+					++n;
+				}
+				return n - first;
+			};
+			if( n < number.size( ) and number[n] == '-' ) {
+				++n;
+			}
+			if( n < number.size( ) and number[n] == '0' ) {
+				++n;
+			} else if( digits( ) == 0 ) {
+				return false;
+			}
+			if( n < number.size( ) and number[n] == '.' ) {
+				++n;
+				if( digits( ) == 0 ) {
+					return false;
+				}
+			}
+			if( n < number.size( ) and ( ( number[n] == 'e' ) | ( number[n] == 'E' ) ) ) {
+				++n;
+				if( n < number.size( ) and ( ( number[n] == '+' ) | ( number[n] == '-' ) ) ) {
+					++n;
+				}
+				if( digits( ) == 0 ) {
+					return false;
+				}
+			}
+			return n == number.size( );
+		}
+
+		enum class parse_state_t { value, member, element, after_value };
+	} // namespace
+
+	json_parse_error::json_parse_error( std::string const &message, std::size_t pos )
+	  : std::runtime_error( message + " at offset " + std::to_string( pos ) )
+	  , offset( pos ) {}
+
+	json_event_parser::json_event_parser( json_source &source ) noexcept
+	  : m_source( &source ) {}
+
+	bool json_event_parser::fill( ) {
+		while( m_chunk.empty( ) ) {
+			m_chunk = m_source->next_chunk( );
+			if( m_chunk.empty( ) ) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	char json_event_parser::peek( ) {
+		if( not fill( ) ) {
+			error( "Unexpected end of input" );
+		}
+		return m_chunk.front( );
+	}
+
+	char json_event_parser::get( ) {
+		char const result = peek( );
+		m_chunk.remove_prefix( 1 );
+		++m_offset;
+		return result;
+	}
+
+	void json_event_parser::expect( char c ) {
+		if( get( ) != c ) {
+			error( "Unexpected character" );
+		}
+	}
+
+	void json_event_parser::skip_ws( ) {
+		while( fill( ) ) {
+			std::size_t n = 0;
+			while( n < m_chunk.size( ) and is_ws( m_chunk[n] ) ) {
+				++n;
+			}
+			m_chunk.remove_prefix( n );
+			m_offset += n;
+			if( not m_chunk.empty( ) ) {
+				return;
+			}
+		}
+	}
+
+	void json_event_parser::error( char const *message ) const {
+		throw json_parse_error( message, m_offset );
+	}
+
+	/// Read the body of a string into m_token after the opening quote has been
+	/// consumed.  Escapes are kept as is
+	void json_event_parser::read_string( ) {
+		m_token.clear( );
+		while( true ) {
+			if( not fill( ) ) {
+				error( "Unterminated string" );
+			}
+			std::size_t n = 0;
+			while( n < m_chunk.size( ) and m_chunk[n] != '"' and m_chunk[n] != '\\' ) {
+				++n;
+			}
+			m_token.append( m_chunk.data( ), n );
+			m_chunk.remove_prefix( n );
+			m_offset += n;
+			if( m_chunk.empty( ) ) {
+				continue;
+			}
+			if( get( ) == '"' ) {
+				return;
+			}
+			m_token += '\\';
+			m_token += get( );
+		}
+	}
+
+	/// Skip the body of a string after the opening quote has been consumed
+	void json_event_parser::skip_string( ) {
+		while( true ) {
+			if( not fill( ) ) {
+				error( "Unterminated string" );
+			}
+			std::size_t n = 0;
+			while( n < m_chunk.size( ) and m_chunk[n] != '"' and m_chunk[n] != '\\' ) {
+				++n;
+			}
+			m_chunk.remove_prefix( n );
+			m_offset += n;
+			if( m_chunk.empty( ) ) {
+				continue;
+			}
+			if( get( ) == '"' ) {
+				return;
+			}
+			get( );
+		}
+	}
+
+	/// Skip a whole value without reporting it.  This only tracks nesting and
+	/// strings, the skipped text is not validated
+	void json_event_parser::skip_value( ) {
+		std::size_t depth = 0;
+		while( true ) {
+			char const c = peek( );
+			if( depth == 0 and ( ( c == ',' ) | ( c == ']' ) | ( c == '}' ) | is_ws( c ) ) ) {
+				return;
+			}
+			get( );
+			switch( c ) {
+			case '"':
+				skip_string( );
+				if( depth == 0 ) {
+					return;
+				}
+				break;
+			case '{':
+			case '[':
+				++depth;
+				break;
+			case '}':
+			case ']':
+				if( --depth == 0 ) {
+					return;
+				}
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	/// Read a number into m_token
+	/// \return true if the number has a fraction or exponent part
+	/// \throws json_parse_error if the number does not follow the JSON grammar
+	bool json_event_parser::read_number( ) {
+		m_token.clear( );
+		bool is_real = false;
+		while( fill( ) ) {
+			std::size_t n = 0;
+			while( n < m_chunk.size( ) and is_number_char( m_chunk[n] ) ) {
+				char const c = m_chunk[n];
+				is_real |= ( c == '.' ) | ( c == 'e' ) | ( c == 'E' );
+				++n;
+			}
+			m_token.append( m_chunk.data( ), n );
+			m_chunk.remove_prefix( n );
+			m_offset += n;
+			if( not m_chunk.empty( ) ) {
+				break;
+			}
+		}
+		if( not is_valid_number( m_token ) ) {
+			m_offset -= m_token.size( );
+			error( "Invalid number" );
+		}
+		return is_real;
+	}
+
+	void json_event_parser::read_literal( daw::string_view literal ) {
+		for( char c : literal ) {
+			if( get( ) != c ) {
+				error( "Invalid literal" );
+			}
+		}
+	}
+
+	bool json_event_parser::parse_value( json_event_handler &handler ) {
+		skip_ws( );
+		if( not fill( ) ) {
+			return false;
+		}
+		m_stack.clear( );
+		auto state = parse_state_t::value;
+		while( true ) {
+			switch( state ) {
+			case parse_state_t::value:
+				switch( char const c = peek( ) ) {
+				case '{':
+					get( );
+					handler.on_object_begin( );
+					skip_ws( );
+					if( peek( ) == '}' ) {
+						get( );
+						handler.on_object_end( );
+						state = parse_state_t::after_value;
+					} else {
+						m_stack.push_back( '{' );
+						state = parse_state_t::member;
+					}
+					break;
+				case '[':
+					get( );
+					handler.on_array_begin( );
+					skip_ws( );
+					if( peek( ) == ']' ) {
+						get( );
+						handler.on_array_end( );
+						state = parse_state_t::after_value;
+					} else {
+						m_stack.push_back( '[' );
+						state = parse_state_t::element;
+					}
+					break;
+				case '"':
+					get( );
+					read_string( );
+					handler.on_string( m_token );
+					state = parse_state_t::after_value;
+					break;
+				case 't':
+					read_literal( "true" );
+					handler.on_boolean( true );
+					state = parse_state_t::after_value;
+					break;
+				case 'f':
+					read_literal( "false" );
+					handler.on_boolean( false );
+					state = parse_state_t::after_value;
+					break;
+				case 'n':
+					read_literal( "null" );
+					handler.on_null( );
+					state = parse_state_t::after_value;
+					break;
+				default:
+					if( c != '-' and not is_digit( c ) ) {
+						error( "Unexpected character" );
+					}
+					{
+						bool const is_real = read_number( );
+						handler.on_number( m_token, is_real );
+					}
+					state = parse_state_t::after_value;
+					break;
+				}
+				break;
+			case parse_state_t::member:
+				skip_ws( );
+				expect( '"' );
+				read_string( );
+				handler.on_member_name( m_token );
+				skip_ws( );
+				expect( ':' );
+				skip_ws( );
+				state = parse_state_t::value;
+				break;
+			case parse_state_t::element:
+				skip_ws( );
+				if( handler.on_array_element( ) ) {
+					state = parse_state_t::value;
+				} else {
+					skip_value( );
+					state = parse_state_t::after_value;
+				}
+				break;
+			case parse_state_t::after_value:
+				if( m_stack.empty( ) ) {
+					return true;
+				}
+				skip_ws( );
+				switch( get( ) ) {
+				case ',':
+					if( m_stack.back( ) == '{' ) {
+						state = parse_state_t::member;
+					} else {
+						state = parse_state_t::element;
+					}
+					break;
+				case '}':
+					if( m_stack.back( ) != '{' ) {
+						error( "Mismatched '}'" );
+					}
+					m_stack.pop_back( );
+					handler.on_object_end( );
+					break;
+				case ']':
+					if( m_stack.back( ) != '[' ) {
+						error( "Mismatched ']'" );
+					}
+					m_stack.pop_back( );
+					handler.on_array_end( );
+					break;
+				default:
+					error( "Expected ',' or end of container" );
+				}
+				break;
+			}
+		}
+	}
+
+	void json_event_parser::parse_document( json_event_handler &handler ) {
+		if( not parse_value( handler ) ) {
+			error( "Empty input" );
+		}
+		skip_ws( );
+		if( fill( ) ) {
+			error( "Unexpected data after the value" );
+		}
+	}
+} // namespace daw::json_to_cpp
@@ -0,0 +1,52 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <utility>
+
+#include <daw/daw_string_view.h>
+
+#include "json_source.h"
+
+namespace daw::json_to_cpp {
+	string_source::string_source( daw::string_view data ) noexcept
+	  : m_data( data ) {}
+
+	daw::string_view string_source::next_chunk( ) {
+		return std::exchange( m_data, daw::string_view( ) );
+	}
+
+	file_source::file_source( std::filesystem::path const &path, std::size_t chunk_size )
+	  : m_file( std::fopen( path.string( ).c_str( ), "rb" ) )
+	  , m_owns_file( true )
+	  , m_buffer( chunk_size ) {}
+
+	file_source::file_source( std::FILE *file, std::size_t chunk_size )
+	  : m_file( file )
+	  , m_buffer( chunk_size ) {}
+
+	file_source::~file_source( ) {
+		if( m_owns_file and m_file != nullptr ) {
+			std::fclose( m_file );
+		}
+	}
+
+	daw::string_view file_source::next_chunk( ) {
+		if( m_file == nullptr ) {
+			return { };
+		}
+		auto const count = std::fread( m_buffer.data( ), 1, m_buffer.size( ), m_file );
+		if( count == 0 and std::ferror( m_file ) ) {
+			throw std::runtime_error( "Error reading json input" );
+		}
+		return daw::string_view( m_buffer.data( ), count );
+	}
+} // namespace daw::json_to_cpp
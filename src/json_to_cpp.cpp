@@ -6,111 +6,39 @@
 // Official repository: https://github.com/beached/daw_json_link
 //
 
+#include "code_emitter.h"
+#include "identifier_table.h"
+#include "json_events.h"
+#include "json_source.h"
 #include "json_to_cpp.h"
+#include "parallel.h"
 #include "ti_value.h"
+#include "types/ti_arena.h"
 #include "types/ti_types.h"
 
-#include <daw/daw_bounded_hash_set.h>
 #include <daw/daw_string_view.h>
 #include <daw/daw_visit.h>
-#include <daw/json/daw_json_parser.h>
 
 #include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
 #include <fmt/core.h>
+#include <iostream>
+#include <iterator>
 #include <limits>
+#include <memory>
+#include <random>
 #include <string>
 #include <typeindex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace daw::json_to_cpp {
 	namespace {
-		struct state_t {
-			bool has_arrays = false;
-			bool has_integrals = false;
-			bool has_optionals = false;
-			bool has_strings = false;
-			bool has_kv = false;
-			std::vector<std::string> path = { };
-		};
-
-		bool is_valid_id_char( char c ) noexcept {
-			return ( std::isalnum( c ) != 0 ) | ( c == '_' ) | ( c != '~' );
-		}
-
-		std::string
-		find_replace( std::string subject, std::string const &search, std::string const &replace ) {
-			size_t pos = 0;
-			while( ( pos = subject.find( search, pos ) ) != std::string::npos ) {
-				subject.replace( pos, search.length( ), replace );
-				pos += replace.length( );
-			}
-			return subject;
-		}
-
-		/// Add a "json_" prefix to C++ keywords and escape non representable
-		/// characters
-		///
-		/// \param name Name of identifier
-		/// \return A valid C++ identifier
-		std::string make_compliant_names( std::string name ) {
-			// These identifiers cannot be used in c++, we will prefix them to keep
-			// them from colliding with keywords
-			// clang-format off
-			static constexpr auto keywords =
-					daw::make_bounded_hash_set<daw::string_view>( {
-							"alignas", "alignof", "and", "and_eq", "asm",	"atomic_cancel", "atomic_commit",
-							"atomic_noexcept", "auto", "bitand", "bitor", "bool",	"break", "case", "catch",
-							"char", "char8_t", "char16_t", "char32_t", "class", "compl", "concept", "const",
-							"consteval", "constexpr", "constinit", "co_await", "co_return", "co_yield",
-							"const_cast", "continue", "decltype", "default", "delete", "do", "double", "dynamic_cast",
-							"else", "enum", "explicit", "export", "extern", "false", "float", "for", "friend",
-							"goto", "if", "import", "", "int", "long", "module", "mutable", "namespace",
-							"new", "noexcept", "not", "not_eq", "nullptr", "operator", "or", "or_eq", "private",
-							"protected", "public", "register", "reinterpret_cast", "requires", "return", "short",
-							"signed", "sizeof", "small", "static", "static_assert", "static_cast", "struct", "switch", "synchronized",
-							"template", "this", "thread_local", "throw", "true", "try", "typedef", "typeid", "typename",
-							"union", "unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq"} );
-			// clang-format on
-			// Remove escaped things
-			name = find_replace( name, "\\U", "0x" );
-			name = find_replace( name, "\\u", "0x" );
-			// JSON member names are strings.  That is it, so empty looks
-			// like it is valid, as is all digits, or C++ keywords.
-			if( auto pos = name.find( '@' ); pos != std::string::npos ) {
-				name[pos] = '_';
-			}
-			if( name.empty( ) or not( std::isalpha( name.front( ) ) or name.front( ) == '_' ) or
-			    keywords.count( { name.data( ), name.size( ) } ) > 0 ) {
-
-				std::string const prefix = "_json";
-				name.insert( name.begin( ), prefix.begin( ), prefix.end( ) );
-			}
-			// Look for characters that are not in the basic standard 5.10
-			// non-digit or digit and escape them
-			auto new_name = std::string( );
-			daw::algorithm::transform_it( name.begin( ),
-			                              name.end( ),
-			                              std::back_inserter( new_name ),
-			                              []( char c, auto it ) {
-				                              if( not is_valid_id_char( c ) ) {
-					                              std::string const new_value =
-					                                "0x" + std::to_string( static_cast<int>( c ) );
-					                              it = std::copy( new_value.begin( ), new_value.end( ), it );
-				                              } else {
-					                              *it++ = c;
-				                              }
-				                              return it;
-			                              } );
-			return new_name;
-		}
-
-		std::vector<types::ti_object>::iterator find_by_name( std::vector<types::ti_object> &obj_info,
-		                                                      daw::string_view name ) {
-			return std::find_if(
-			  obj_info.begin( ),
-			  obj_info.end( ),
-			  [n = static_cast<std::string>( name )]( auto const &item ) { return n == item.name( ); } );
-		}
-
 		template<typename Variant>
 		constexpr bool is_double( Variant &&v ) noexcept {
 			return std::holds_alternative<types::ti_real>( v );
@@ -185,300 +113,1429 @@ namespace daw::json_to_cpp {
 			return daw::visit_nt( std::forward<Variant>( v ),
 			                      []( auto &&item ) { return item.is_null; } );
 		}
-		void add_or_merge( std::vector<types::ti_object> &obj_info, types::ti_object &obj ) {
-			auto pos = find_by_name( obj_info, { obj.name( ).data( ), obj.name( ).size( ) } );
-			if( obj_info.end( ) == pos ) {
-				// First time
-				obj_info.push_back( obj );
-				return;
+		/// Combine another observation of a value with the type already known for
+		/// it.  A null makes the known type optional, an integral becomes a real
+		/// when a real is seen, the ranges of numbers and array lengths are
+		/// widened, the values of strings are combined and the element types of
+		/// arrays and KV maps are merged.  Any other mismatch keeps the known type
+		/// \return true if orig changed
+		bool merge_type( types::ti_types_t &orig, types::ti_types_t const &incoming );
+
+		/// Merge every entry of incoming into orig.  Entries that orig does not
+		/// have are copied
+		/// \return true if orig changed
+		bool merge_children( types::ti_object::child_t &orig,
+		                     types::ti_object::child_t const *incoming ) {
+			if( incoming == nullptr ) {
+				return false;
 			}
+			bool changed = false;
+			for( auto const &child : *incoming ) {
+				auto [pos, is_new] = orig.try_emplace( child.first );
+				if( is_new ) {
+					pos->second = child.second;
+					changed = true;
+				} else {
+					changed |= merge_type( pos->second, child.second );
+				}
+			}
+			return changed;
+		}
 
-			auto diff = std::vector<std::pair<std::string, types::ti_value>>( );
-			for( auto &orig_child : *pos->children ) {
-				auto child_pos =
-				  std::find_if( obj.children->begin( ), obj.children->end( ), [&]( auto const &v ) {
-					  return v.first == orig_child.first;
-				  } );
-				if( child_pos == obj.children->end( ) ) {
-					is_optional( orig_child.second ) = true;
-					continue;
+		bool merge_type( types::ti_types_t &orig, types::ti_types_t const &incoming ) {
+			using namespace daw::json_to_cpp::types;
+			if( is_null( incoming ) ) {
+				bool const changed = not is_optional( orig );
+				is_optional( orig ) = true;
+				return changed;
+			}
+			if( is_null( orig ) ) {
+				orig = incoming;
+				is_optional( orig ) = true;
+				return true;
+			}
+			bool changed = false;
+			if( is_double( incoming ) and std::holds_alternative<ti_integral>( orig ) ) {
+				// Account for when the LHS is an int but the value should actually
+				// be a double
+				auto const is_opt = is_optional( orig );
+				auto const fits_float = std::get<ti_integral>( orig ).fits_float( );
+				orig = incoming;
+				is_optional( orig ) = is_optional( orig ) or is_opt;
+				auto &real = std::get<ti_real>( orig );
+				real.is_float = real.is_float and fits_float;
+				return true;
+			} else if( auto *integral = std::get_if<ti_integral>( &orig ) ) {
+				if( auto const *other = std::get_if<ti_integral>( &incoming ) ) {
+					changed = integral->merge( *other );
 				}
-				if( is_null( child_pos->second ) ) {
-					is_optional( orig_child.second ) = true;
-				} else if( is_null( orig_child.second ) ) {
-					orig_child.second = child_pos->second;
-					is_optional( orig_child.second ) = true;
-				} else if( is_double( child_pos->second ) ) {
-					// Account for when the LHS is an int but the value should actually
-					// be a double
-					auto const is_opt = is_optional( orig_child.second );
-					orig_child.second = orig_child.second;
-					is_optional( orig_child.second ) = is_optional( orig_child.second ) or is_opt;
+			} else if( auto *real = std::get_if<ti_real>( &orig ) ) {
+				// The integrals seen later must be exact as a float too
+				if( real->is_float ) {
+					if( auto const *other_real = std::get_if<ti_real>( &incoming ) ) {
+						changed = not other_real->is_float;
+					} else if( auto const *other_int = std::get_if<ti_integral>( &incoming ) ) {
+						changed = not other_int->fits_float( );
+					}
+					real->is_float = not changed;
+				}
+			} else if( auto *str = std::get_if<ti_string>( &orig ) ) {
+				// A string whose values are not tracked stays that way
+				if( auto const *other = std::get_if<ti_string>( &incoming );
+				    other != nullptr and str->values != nullptr and other->values != nullptr ) {
+					changed = str->values->merge( *other->values );
+				}
+			} else if( auto *arry = std::get_if<ti_array>( &orig ) ) {
+				if( auto const *other = std::get_if<ti_array>( &incoming ) ) {
+					changed = merge_children( *arry->children, other->children );
+					changed |= arry->merge_sizes( *other );
+				}
+			} else if( auto *kv = std::get_if<ti_kv>( &orig ) ) {
+				if( auto const *other = std::get_if<ti_kv>( &incoming ) ) {
+					changed = merge_children( *kv->value, other->value );
 				}
 			}
+			if( is_optional( incoming ) and not is_optional( orig ) ) {
+				is_optional( orig ) = true;
+				changed = true;
+			}
+			return changed;
 		}
 
-		types::ti_types_t merge_array_values( types::ti_value a, types::ti_value b ) {
-			if( a.is_null( ) ) {
-				b.is_optional( ) = true;
-				return b.value;
+		/// The type of one integer when numbers are narrowed.  The range always
+		/// includes 0, which does not change the type that holds it
+		types::ti_integral narrow_integral( daw::string_view text, std::uint8_t margin_bits ) {
+			auto const *const first = text.data( );
+			auto const *const last = first + text.size( );
+			std::int64_t value = 0;
+			if( auto const [ptr, ec] = std::from_chars( first, last, value ); ec == std::errc( ) and ptr == last ) {
+				return types::ti_integral( std::min<std::int64_t>( value, 0 ),
+				                           static_cast<std::uint64_t>( std::max<std::int64_t>( value, 0 ) ),
+				                           margin_bits );
+			}
+			std::uint64_t uvalue = 0;
+			if( auto const [ptr, ec] = std::from_chars( first, last, uvalue ); ec == std::errc( ) and ptr == last ) {
+				return types::ti_integral( 0, uvalue, margin_bits );
 			}
-			a.is_optional( ) |= b.is_optional( );
-			return a.value;
+			// Beyond 64 bits, keep the default
+			return types::ti_integral( );
 		}
 
-		types::ti_types_t parse_json_object( daw::json::json_value_t const &current_item,
-		                                     daw::string_view cur_name,
-		                                     std::vector<types::ti_object> &obj_info,
-		                                     state_t &obj_state,
-		                                     config_t const &config ) {
+		/// The type of one real when numbers are narrowed
+		types::ti_real narrow_real( daw::string_view text ) {
+			auto const *const first = text.data( );
+			auto const *const last = first + text.size( );
+			double value = 0.0;
+			if( auto const [ptr, ec] = std::from_chars( first, last, value ); ec != std::errc( ) or ptr != last ) {
+				return types::ti_real( );
+			}
+			// Converting a double outside the range of float is undefined
+			if( not( std::abs( value ) <= static_cast<double>( std::numeric_limits<float>::max( ) ) ) ) {
+				return types::ti_real( );
+			}
+			return types::ti_real( static_cast<double>( static_cast<float>( value ) ) == value );
+		}
 
-			using daw::json::json_value_t;
-			using namespace daw::json_to_cpp::types;
-			if( current_item.is_integer( ) ) {
-				obj_state.has_integrals = true;
-				return ti_integral( );
+		/// Merge another instance of an object into the one already known.  The
+		/// member counts are added, they are not part of the type
+		/// \return true if the type of orig changed
+		bool merge_object( types::ti_object &orig, types::ti_object const &obj ) {
+			bool changed = false;
+			if( obj.counts == nullptr ) {
+				orig.counts = nullptr;
+			} else if( orig.counts != nullptr ) {
+				orig.counts->instances += obj.counts->instances;
+			}
+			for( auto &orig_child : *orig.children ) {
+				if( not obj.children->contains( orig_child.first ) ) {
+					changed |= not is_optional( orig_child.second );
+					is_optional( orig_child.second ) = true;
+				}
+			}
+			// Members that the first instances did not have are optional
+			std::size_t idx = 0;
+			for( auto const &child : *obj.children ) {
+				auto [pos, is_new] = orig.children->try_emplace( child.first );
+				if( orig.counts != nullptr ) {
+					orig.counts->add_present( static_cast<std::size_t>( pos - orig.children->begin( ) ),
+					                          obj.counts->present_count( idx ) );
+				}
+				++idx;
+				if( is_new ) {
+					pos->second = child.second;
+					is_optional( pos->second ) = true;
+					changed = true;
+				} else {
+					changed |= merge_type( pos->second, child.second );
+				}
+			}
+			return changed;
+		}
+
+		/// Builds the type information directly from parser events.  Every value
+		/// is merged into the known type of its member or element as soon as it is
+		/// seen, so nothing is allocated per instance and memory use is bounded by
+		/// the size of the schema and not the size of the document
+		class inference_handler final : public json_event_handler {
+			enum class frame_kind_t { object, array, kv, ignored };
+
+			struct frame_t {
+				frame_kind_t kind = frame_kind_t::ignored;
+				// The members, elements or values of the known type
+				types::ti_object::child_t *children = nullptr;
+				// Objects, how often the type and its members were seen
+				types::member_counts_t *counts = nullptr;
+				// The current member, or the name shared by all elements or values
+				std::string_view child_name{ };
+				// The object the members, elements or values belong to, enums are
+				// named after it
+				std::string_view owner_name{ };
+				// Objects
+				bool is_first_instance = false;
+				bool is_root_wrapper = false;
+				std::vector<bool> seen{ };
+				// Array sampling
+				std::size_t element_count = 0;
+				std::size_t unchanged_count = 0;
+				std::size_t generation = 0;
+			};
+
+			object_registry_t *m_obj_info;
+			state_t *m_obj_state;
+			types::ti_arena *m_arena;
+			identifier_table_t *m_identifiers;
+			config_t const *m_config;
+			// Reused to build derived names without allocating
+			std::string m_scratch{ };
+			// Frames are reused so that their storage is only allocated once per
+			// level of nesting
+			std::vector<frame_t> m_stack{ };
+			std::size_t m_depth = 0;
+			std::vector<std::string_view> m_path{ };
+			// Incremented whenever a known type changes
+			std::size_t m_generation = 0;
+			std::mt19937_64 m_rng;
+			std::uint8_t m_margin_bits;
+			std::uint32_t m_fixed_size_max;
+			std::uint32_t m_small_size_max;
+
+			frame_t &top( ) {
+				return m_stack[m_depth - 1U];
+			}
+
+			frame_t &push_frame( frame_kind_t kind,
+			                     types::ti_object::child_t *children,
+			                     std::string_view child_name ) {
+				// Arrays and KV maps belong to the object they are in
+				auto const owner_name = m_depth == 0 ? std::string_view( ) : top( ).owner_name;
+				if( m_depth == m_stack.size( ) ) {
+					m_stack.emplace_back( );
+				}
+				auto &frame = m_stack[m_depth++];
+				frame.kind = kind;
+				frame.children = children;
+				frame.counts = nullptr;
+				frame.child_name = child_name;
+				frame.owner_name = owner_name;
+				frame.is_first_instance = false;
+				frame.is_root_wrapper = false;
+				frame.seen.clear( );
+				frame.element_count = 0;
+				frame.unchanged_count = 0;
+				frame.generation = 0;
+				return frame;
 			}
-			if( current_item.is_real( ) ) {
-				return ti_real( );
+
+			std::string_view intern( std::string_view name ) {
+				return m_arena->intern( name );
 			}
-			if( current_item.is_boolean( ) ) {
-				return ti_boolean( );
+
+			/// \return name followed by suffix, valid until the next call
+			std::string_view with_suffix( std::string_view name, char const *suffix ) {
+				m_scratch.assign( name.data( ), name.size( ) );
+				m_scratch += suffix;
+				return m_scratch;
 			}
-			if( current_item.is_string( ) ) {
-				obj_state.has_strings = true;
-				return ti_string( config.use_string_view );
+
+			std::string_view next_name( ) {
+				if( m_depth == 0 ) {
+					return intern( m_config->root_object_name );
+				}
+				return top( ).child_name;
 			}
-			if( current_item.is_null( ) ) {
-				obj_state.has_optionals = true;
-				return ti_null( );
+
+			/// A document whose root is not an object is treated as an object with a
+			/// single member named after the root object
+			void wrap_root( ) {
+				if( m_depth != 0 ) {
+					return;
+				}
+				open_object( intern( m_config->root_object_name ) );
+				top( ).child_name = m_identifiers->get( m_config->root_object_name );
+				top( ).is_root_wrapper = true;
 			}
-			if( current_item.is_object( ) ) {
-				obj_state.path.push_back( static_cast<std::string>( cur_name ) );
-				auto const oe = daw::on_scope_exit( [&obj_state]( ) { obj_state.path.pop_back( ); } );
-				if( config.path_matches( obj_state.path ) ) {
+
+			/// Merge a value into the type of the current member, element or value
+			/// of the innermost container
+			/// \return The merged type, or null if the value is not part of a type
+			types::ti_types_t *observe( types::ti_types_t const &value ) {
+				if( m_depth == 0 or top( ).kind == frame_kind_t::ignored ) {
+					return nullptr;
+				}
+				auto &cur = top( );
+				auto [pos, is_new] = cur.children->try_emplace( cur.child_name );
+				if( is_new ) {
+					pos->second = value;
+					// Members that the first instance did not have are optional
+					if( cur.kind == frame_kind_t::object and not cur.is_first_instance ) {
+						is_optional( pos->second ) = true;
+					}
+					++m_generation;
+				} else if( merge_type( pos->second, value ) ) {
+					++m_generation;
+				}
+				if( cur.kind == frame_kind_t::object ) {
+					auto const idx = static_cast<std::size_t>( pos - cur.children->begin( ) );
+					if( idx >= cur.seen.size( ) ) {
+						cur.seen.resize( idx + 1U, false );
+					}
+					// A repeated key is one member
+					if( not cur.seen[idx] ) {
+						cur.seen[idx] = true;
+						cur.counts->add_present( idx, 1U );
+					}
+				}
+				return &pos->second;
+			}
+
+			/// Called after a complete value has been merged into its parent
+			void end_value( ) {
+				if( m_depth == 0 ) {
+					return;
+				}
+				auto &cur = top( );
+				if( cur.is_root_wrapper ) {
+					close_object( );
+				} else if( cur.kind == frame_kind_t::array ) {
+					cur.unchanged_count = cur.generation == m_generation ? cur.unchanged_count + 1 : 0;
+				}
+			}
+
+			void open_object( std::string_view cur_name ) {
+				using namespace daw::json_to_cpp::types;
+				m_path.push_back( cur_name );
+				if( m_depth != 0 and top( ).kind == frame_kind_t::ignored ) {
+					// The whole subtree of a value that is not part of a type is
+					// skipped, its objects have no name to be registered under
+					push_frame( frame_kind_t::ignored, nullptr, { } );
+					return;
+				}
+				if( m_config->path_matches( m_path ) ) {
 					// KV Map
-					obj_state.has_kv = true;
-					auto result = ti_kv( static_cast<std::string>( cur_name ) );
-					auto const &children = current_item.get_object( );
-					auto first = children.begin( );
-					auto value_name = make_compliant_names( static_cast<std::string>( cur_name ) + "_value" );
-					( *result.value )[value_name] =
-					  parse_json_object( first->second, value_name, obj_info, obj_state, config );
-					++first;
-					while( first != children.end( ) ) {
-						( *result.value )[value_name] = merge_array_values(
-						  ti_value( ( *result.value )[value_name] ),
-						  ti_value(
-						    parse_json_object( first->second, value_name, obj_info, obj_state, config ) ) );
-						++first;
+					m_obj_state->has_kv = true;
+					auto *slot = observe( ti_kv( cur_name, nullptr ) );
+					auto *kv = slot == nullptr ? nullptr : std::get_if<ti_kv>( slot );
+					if( kv == nullptr ) {
+						push_frame( frame_kind_t::ignored, nullptr, { } );
+						return;
+					}
+					if( kv->value == nullptr ) {
+						kv->value = m_arena->make_children( );
 					}
+					push_frame( frame_kind_t::kv,
+					            kv->value,
+					            m_identifiers->get( with_suffix( cur_name, "_value" ) ) );
+					return;
+				}
+				// Object
+				auto const type_name = intern( with_suffix( cur_name, "_t" ) );
+				auto [obj, is_new] = m_obj_info->try_emplace( type_name, [&] {
+					auto result = ti_object( type_name, m_arena->make_children( ) );
+					result.counts = m_arena->make_member_counts( );
 					return result;
+				} );
+				if( is_new ) {
+					++m_generation;
 				} else {
-					// Object
-					auto result = ti_object( static_cast<std::string>( cur_name ) + "_t" );
-					for( auto const &child : current_item.get_object( ) ) {
-						std::string const child_name = make_compliant_names( child.first.to_string( ) );
-						( *result.children )[child_name] =
-						  parse_json_object( child.second, child_name, obj_info, obj_state, config );
+					m_obj_info->count_merge( );
+				}
+				auto *members = obj->children;
+				auto *counts = obj->counts;
+				++counts->instances;
+				observe( ti_object( type_name, members ) );
+				auto &frame = push_frame( frame_kind_t::object, members, { } );
+				frame.counts = counts;
+				frame.owner_name = cur_name;
+				frame.is_first_instance = is_new;
+				frame.seen.assign( members->size( ), false );
+			}
+
+			void close_object( ) {
+				auto &cur = top( );
+				if( cur.kind == frame_kind_t::object and not cur.is_first_instance ) {
+					// Members that this instance did not have are optional
+					std::size_t idx = 0;
+					for( auto &child : *cur.children ) {
+						if( ( idx >= cur.seen.size( ) or not cur.seen[idx] ) and
+						    not is_optional( child.second ) ) {
+							is_optional( child.second ) = true;
+							++m_generation;
+						}
+						++idx;
 					}
-					add_or_merge( obj_info, result );
-					return result;
 				}
+				--m_depth;
+				m_path.pop_back( );
+				end_value( );
+			}
+
+			bool sample_element( frame_t &cur ) {
+				auto const idx = cur.element_count++;
+				switch( m_config->array_sampling ) {
+				case array_sampling_t::all:
+					return true;
+				case array_sampling_t::first_n:
+					return idx < m_config->sample_count;
+				case array_sampling_t::reservoir:
+					// A merged type cannot forget an element, so this is only the
+					// inclusion test of reservoir sampling without the eviction
+					return idx < m_config->sample_count or
+					       std::uniform_int_distribution<std::size_t>( 0, idx )( m_rng ) <
+					         m_config->sample_count;
+				case array_sampling_t::until_stable:
+					return cur.unchanged_count < m_config->sample_count;
+				}
+				return true;
 			}
-			if( current_item.is_array( ) ) {
-				obj_state.has_arrays = true;
-				auto result = ti_array( );
-				auto arry = current_item.get_array( );
-				auto const child_name = static_cast<std::string>( cur_name ) + "_element";
-				if( arry.empty( ) ) {
-					( *result.children )[child_name] = ti_null( );
+
+			void add_scalar( types::ti_types_t const &value ) {
+				wrap_root( );
+				observe( value );
+				end_value( );
+			}
+
+			/// Widen the lengths of the array that was just closed.  It is looked
+			/// up again, as the slot can move while its elements are merged
+			void add_array_size( std::uint64_t length ) {
+				auto &cur = top( );
+				auto pos = cur.children->find( cur.child_name );
+				if( pos == cur.children->end( ) ) {
+					return;
+				}
+				if( auto *arry = std::get_if<types::ti_array>( &pos->second ); arry != nullptr and arry->add_size( length ) ) {
+					++m_generation;
+				}
+			}
+
+			/// The name of an enum for the current member, element or value
+			std::string_view enum_stem( ) {
+				auto const &cur = top( );
+				if( cur.owner_name.empty( ) ) {
+					return cur.child_name;
+				}
+				m_scratch.assign( cur.owner_name.data( ), cur.owner_name.size( ) );
+				m_scratch += '_';
+				m_scratch.append( cur.child_name.data( ), cur.child_name.size( ) );
+				return intern( m_scratch );
+			}
+
+			/// Count value towards the distinct values of str
+			void add_enum_value( types::ti_string &str, std::string_view value ) {
+				if( str.values == nullptr ) {
+					str.values = m_arena->make_string_values( );
+					str.values->max_values = m_config->enum_max_values;
+					str.enum_stem = enum_stem( );
+				}
+				auto &values = *str.values;
+				++values.count;
+				if( values.is_overflow or values.contains( value ) ) {
+					return;
+				}
+				// The converter is given the text as it is in the document, so a
+				// value with escapes would have to be matched escaped.  This also
+				// keeps the values valid as string literals
+				if( std::any_of( value.begin( ), value.end( ), []( char c ) {
+					    return c == '\\' or static_cast<unsigned char>( c ) < 0x20U;
+				    } ) ) {
+					values.set_overflow( );
 				} else {
-					auto const last_item = arry.back( );
-					arry.pop_back( );
-					auto child = parse_json_object( last_item, child_name, obj_info, obj_state, config );
-					for( auto const &element : current_item.get_array( ) ) {
-						child = merge_array_values(
-						  ti_value( child ),
-						  ti_value( parse_json_object( element, child_name, obj_info, obj_state, config ) ) );
-					}
-					( *result.children )[child_name] = child;
+					values.insert( intern( value ) );
 				}
-				return result;
+				++m_generation;
+			}
+
+		public:
+			inference_handler( object_registry_t &obj_info,
+			                   state_t &obj_state,
+			                   types::ti_arena &arena,
+			                   identifier_table_t &identifiers,
+			                   config_t const &config )
+			  : m_obj_info( &obj_info )
+			  , m_obj_state( &obj_state )
+			  , m_arena( &arena )
+			  , m_identifiers( &identifiers )
+			  , m_config( &config )
+			  , m_rng( config.sample_seed )
+			  , m_margin_bits( static_cast<std::uint8_t>( std::min<std::size_t>( config.narrow_margin_bits, 64 ) ) )
+			  , m_fixed_size_max( static_cast<std::uint32_t>(
+			      std::min<std::size_t>( config.fixed_array_max, std::numeric_limits<std::uint32_t>::max( ) ) ) )
+			  , m_small_size_max( static_cast<std::uint32_t>(
+			      std::min<std::size_t>( config.small_vector_max, std::numeric_limits<std::uint32_t>::max( ) ) ) ) {}
+
+			void on_object_begin( ) override {
+				open_object( next_name( ) );
+			}
+
+			void on_member_name( daw::string_view name ) override {
+				auto &cur = top( );
+				// All the values of a KV map share the one value name
+				if( cur.kind == frame_kind_t::object ) {
+					cur.child_name = m_identifiers->get( std::string_view( name.data( ), name.size( ) ) );
+				}
+			}
+
+			void on_object_end( ) override {
+				if( top( ).kind == frame_kind_t::object ) {
+					close_object( );
+					return;
+				}
+				--m_depth;
+				m_path.pop_back( );
+				end_value( );
+			}
+
+			void on_array_begin( ) override {
+				using namespace daw::json_to_cpp::types;
+				wrap_root( );
+				m_obj_state->has_arrays = true;
+				auto *slot = observe( ti_array( m_fixed_size_max, m_small_size_max ) );
+				auto *arry = slot == nullptr ? nullptr : std::get_if<ti_array>( slot );
+				if( arry == nullptr ) {
+					push_frame( frame_kind_t::ignored, nullptr, { } );
+					return;
+				}
+				auto const element_name = intern( with_suffix( next_name( ), "_element" ) );
+				if( arry->children == nullptr ) {
+					arry->children = m_arena->make_children( );
+				}
+				push_frame( frame_kind_t::array, arry->children, element_name );
+			}
+
+			bool on_array_element( ) override {
+				auto &cur = top( );
+				if( not sample_element( cur ) ) {
+					return false;
+				}
+				cur.generation = m_generation;
+				return true;
+			}
+
+			void on_array_end( ) override {
+				auto const &cur = top( );
+				bool const is_array = cur.kind == frame_kind_t::array;
+				auto const length = cur.element_count;
+				--m_depth;
+				if( is_array ) {
+					add_array_size( length );
+				}
+				end_value( );
+			}
+
+			void on_string( daw::string_view value ) override {
+				m_obj_state->has_strings = true;
+				if( m_config->enum_max_values == 0 ) {
+					add_scalar( types::ti_string( m_config->use_string_view ) );
+					return;
+				}
+				wrap_root( );
+				auto *slot = observe( types::ti_string( m_config->use_string_view ) );
+				if( auto *str = slot == nullptr ? nullptr : std::get_if<types::ti_string>( slot ) ) {
+					add_enum_value( *str, std::string_view( value.data( ), value.size( ) ) );
+				}
+				end_value( );
+			}
+
+			void on_number( daw::string_view value, bool is_real ) override {
+				// Only narrowing needs the values, otherwise the numbers are not
+				// parsed at all
+				if( is_real ) {
+					add_scalar( m_config->narrow_numbers ? narrow_real( value ) : types::ti_real( ) );
+				} else {
+					m_obj_state->has_integrals = true;
+					add_scalar( m_config->narrow_numbers ? narrow_integral( value, m_margin_bits )
+					                                     : types::ti_integral( ) );
+				}
+			}
+
+			void on_boolean( bool ) override {
+				add_scalar( types::ti_boolean( ) );
+			}
+
+			void on_null( ) override {
+				m_obj_state->has_optionals = true;
+				add_scalar( types::ti_null( ) );
+			}
+		};
+
+		/// The size of the underlying type of an enum with count enumerators
+		std::size_t enum_underlying_size( std::size_t count ) noexcept {
+			if( count > 0x1'0000U ) {
+				return 4;
+			}
+			if( count > 0x100U ) {
+				return 2;
+			}
+			return 1;
+		}
+
+		char const *enum_underlying_type( std::size_t count ) noexcept {
+			switch( enum_underlying_size( count ) ) {
+			case 4:
+				return "std::uint32_t";
+			case 2:
+				return "std::uint16_t";
+			default:
+				return "std::uint8_t";
 			}
-			std::cerr << "Unexpected exit point to parse_json_object2";
-			std::terminate( );
 		}
 
-		std::vector<types::ti_object> parse_json_object( daw::json::json_value_t const &current_item,
-		                                                 state_t &obj_state,
-		                                                 config_t const &config ) {
-			using namespace daw::json;
-			auto result = std::vector<types::ti_object>( );
+		/// Call func for value and the element types nested in it.  The members
+		/// of objects are not visited
+		template<typename Function>
+		void for_each_nested_type( types::ti_types_t const &value, Function const &func ) {
+			func( value );
+			daw::visit_nt(
+			  value,
+			  [&]( types::ti_array const &arry ) {
+				  if( arry.children != nullptr ) {
+					  for( auto const &child : *arry.children ) {
+						  for_each_nested_type( child.second, func );
+					  }
+				  }
+			  },
+			  [&]( types::ti_kv const &kv ) {
+				  if( kv.value != nullptr ) {
+					  for( auto const &child : *kv.value ) {
+						  for_each_nested_type( child.second, func );
+					  }
+				  }
+			  },
+			  []( auto const & ) {} );
+		}
+
+		/// The size and alignment of a generated type, as estimated for a 64 bit
+		/// target and a common standard library
+		struct type_layout_t {
+			std::size_t size = 0;
+			std::size_t align = 1;
+		};
+
+		constexpr std::size_t round_up( std::size_t value, std::size_t align ) noexcept {
+			return ( value + align - 1U ) / align * align;
+		}
+
+		/// The order the members of an object are declared in, and which of them
+		/// are in its cold struct
+		struct member_layout_t {
+			/// The positions of the generated members, hot members first
+			std::vector<std::size_t> order{ };
+			/// order[cold_begin] and after are in the cold struct
+			std::size_t cold_begin = 0;
+			std::string cold_type{ };
+			/// The member that points to the cold struct
+			std::string cold_member{ };
+			/// The struct of arrays for an array element type, or empty
+			std::string columns_type{ };
+			std::string columns_parser{ };
+			type_layout_t layout{ };
+
+			bool has_cold( ) const noexcept {
+				return cold_begin < order.size( );
+			}
+
+			bool has_columns( ) const noexcept {
+				return not columns_type.empty( );
+			}
+		};
+
+		using member_layouts_t = std::unordered_map<std::string_view, member_layout_t>;
+
+		type_layout_t estimate_layout( types::ti_types_t const &value, member_layouts_t const &layouts ) {
+			using namespace daw::json_to_cpp::types;
+			auto const result = daw::visit_nt(
+			  value,
+			  []( ti_boolean const & ) { return type_layout_t{ 1, 1 }; },
+			  []( ti_integral const &integral ) {
+				  return type_layout_t{ integral.byte_width( ), integral.byte_width( ) };
+			  },
+			  []( ti_real const &real ) { return type_layout_t{ real.byte_width( ), real.byte_width( ) }; },
+			  []( ti_string const &str ) {
+				  if( str.is_enum( ) ) {
+					  auto const bytes = enum_underlying_size( str.values->values.size( ) );
+					  return type_layout_t{ bytes, bytes };
+				  }
+				  return str.use_string_view( ) ? type_layout_t{ 16, 8 } : type_layout_t{ 32, 8 };
+			  },
+			  []( ti_array const & ) { return type_layout_t{ 24, 8 }; },
+			  []( ti_kv const & ) { return type_layout_t{ 56, 8 }; },
+			  [&]( ti_object const &obj ) {
+				  auto const pos = layouts.find( obj.object_name );
+				  return pos == layouts.end( ) ? type_layout_t{ 8, 8 } : pos->second.layout;
+			  },
+			  // void*
+			  []( ti_null const & ) { return type_layout_t{ 8, 8 }; } );
+			if( is_optional( value ) ) {
+				return type_layout_t{ round_up( result.size + 1U, result.align ), result.align };
+			}
+			return result;
+		}
+
+		/// Decide the member order of cur_obj.  Without layout options this is
+		/// the order of the JSON keys.  optimize_layout puts the required members
+		/// first, then the optional ones, each sorted by alignment and size so
+		/// that no padding is needed between them.  cold_member_ratio moves the
+		/// optional members present in fewer than that share of the instances
+		/// into a struct that is only allocated when one of them is present
+		member_layout_t plan_layout( types::ti_object const &cur_obj,
+		                             config_t const &config,
+		                             member_layouts_t const &layouts ) {
+			struct candidate_t {
+				std::size_t idx;
+				type_layout_t layout;
+				bool is_optional;
+				bool is_cold;
+			};
+			auto const *counts = cur_obj.counts;
+			bool const split_cold = config.cold_member_ratio > 0.0 and counts != nullptr and counts->instances > 0;
+			auto candidates = std::vector<candidate_t>( );
+			std::size_t idx = 0;
+			for( auto const &child : *cur_obj.children ) {
+				if( not( config.hide_null_only and is_null( child.second ) ) ) {
+					bool const is_opt = is_optional( child.second );
+					bool const is_cold =
+					  split_cold and is_opt and
+					  static_cast<double>( counts->present_count( idx ) ) <
+					    config.cold_member_ratio * static_cast<double>( counts->instances );
+					candidates.push_back( candidate_t{ idx, estimate_layout( child.second, layouts ), is_opt, is_cold } );
+				}
+				++idx;
+			}
+			std::stable_sort( candidates.begin( ), candidates.end( ), [&]( auto const &lhs, auto const &rhs ) {
+				if( lhs.is_cold != rhs.is_cold ) {
+					return rhs.is_cold;
+				}
+				if( not config.optimize_layout ) {
+					return false;
+				}
+				if( lhs.is_optional != rhs.is_optional ) {
+					return rhs.is_optional;
+				}
+				if( lhs.layout.align != rhs.layout.align ) {
+					return lhs.layout.align > rhs.layout.align;
+				}
+				return lhs.layout.size > rhs.layout.size;
+			} );
+
+			auto result = member_layout_t( );
+			result.order.reserve( candidates.size( ) );
+			result.cold_begin = candidates.size( );
+			std::size_t offset = 0;
+			for( auto const &candidate : candidates ) {
+				if( candidate.is_cold ) {
+					result.cold_begin = std::min( result.cold_begin, result.order.size( ) );
+				} else {
+					offset = round_up( offset, candidate.layout.align ) + candidate.layout.size;
+					result.layout.align = std::max( result.layout.align, candidate.layout.align );
+				}
+				result.order.push_back( candidate.idx );
+			}
+			if( result.has_cold( ) ) {
+				auto const stem = cur_obj.object_name.substr( 0, cur_obj.object_name.rfind( "_t" ) );
+				result.cold_type = std::string( stem ) + "_cold_t";
+				// Unlike the members, the pointer has no JSON name to keep
+				result.cold_member = "cold";
+				while( cur_obj.children->contains( result.cold_member ) ) {
+					result.cold_member += '_';
+				}
+				offset = round_up( offset, 8U ) + 8U;
+				result.layout.align = std::max<std::size_t>( result.layout.align, 8U );
+			}
+			result.layout.size = std::max<std::size_t>( round_up( offset, result.layout.align ), 1U );
+			return result;
+		}
+
+		/// \return The objects that are the elements of an array and whose
+		/// members are all booleans, numbers or strings
+		std::unordered_set<std::string_view> find_column_types( std::vector<types::ti_object const *> const &obj_info,
+		                                                        config_t const &config ) {
+			auto elements = std::unordered_set<std::string_view>( );
+			for( auto const *cur_obj : obj_info ) {
+				for( auto const &child : *cur_obj->children ) {
+					for_each_nested_type( child.second, [&]( types::ti_types_t const &type ) {
+						auto const *arry = std::get_if<types::ti_array>( &type );
+						if( arry == nullptr or arry->children == nullptr ) {
+							return;
+						}
+						for( auto const &element : *arry->children ) {
+							if( auto const *obj = std::get_if<types::ti_object>( &element.second ) ) {
+								elements.insert( obj->object_name );
+							}
+						}
+					} );
+				}
+			}
+			auto result = std::unordered_set<std::string_view>( );
+			for( auto const *cur_obj : obj_info ) {
+				if( elements.count( cur_obj->object_name ) == 0 ) {
+					continue;
+				}
+				bool has_column = false;
+				bool is_scalar = true;
+				for( auto const &child : *cur_obj->children ) {
+					if( config.hide_null_only and is_null( child.second ) ) {
+						continue;
+					}
+					has_column = true;
+					is_scalar &= std::holds_alternative<types::ti_boolean>( child.second ) or
+					             std::holds_alternative<types::ti_integral>( child.second ) or
+					             std::holds_alternative<types::ti_real>( child.second ) or
+					             std::holds_alternative<types::ti_string>( child.second );
+				}
+				if( has_column and is_scalar ) {
+					result.insert( cur_obj->object_name );
+				}
+			}
+			return result;
+		}
 
-			if( current_item.is_object( ) ) {
-				parse_json_object( current_item, config.root_object_name, result, obj_state, config );
-			} else {
-				auto root_obj_member =
-				  daw::json::make_object_value_item( config.root_object_name.c_str( ), current_item );
-				auto root_object = json_object_value( );
-				root_object.members_v.push_back( std::move( root_obj_member ) );
-				auto root_value = json_value_t( std::move( root_object ) );
-				parse_json_object( root_value, config.root_object_name, result, obj_state, config );
+		/// Plan the layouts of the objects, the types of their members must come
+		/// first
+		member_layouts_t plan_layouts( std::vector<types::ti_object const *> const &obj_info,
+		                               config_t const &config ) {
+			auto result = member_layouts_t( );
+			auto const column_types =
+			  config.struct_of_arrays ? find_column_types( obj_info, config ) : std::unordered_set<std::string_view>( );
+			for( auto const *cur_obj : obj_info ) {
+				auto layout = plan_layout( *cur_obj, config, result );
+				if( column_types.count( cur_obj->object_name ) != 0 ) {
+					auto const stem = cur_obj->object_name.substr( 0, cur_obj->object_name.rfind( "_t" ) );
+					layout.columns_type = std::string( stem ) + "_columns_t";
+					layout.columns_parser = "parse_" + std::string( stem ) + "_columns";
+				}
+				result.emplace( cur_obj->object_name, std::move( layout ) );
 			}
 			return result;
 		}
 
+		/// A parser for a JSON array of cur_obj that moves each element into the
+		/// columns as it is parsed, without a std::vector of the elements
+		void generate_columns_parser( code_emitter_t &out,
+		                              types::ti_object const &cur_obj,
+		                              member_layout_t const &layout ) {
+			auto const member_name = [&]( std::size_t n ) -> auto const & {
+				return cur_obj.children->begin( )[static_cast<std::ptrdiff_t>( layout.order[n] )].first;
+			};
+			out << "\n/// Parse the array at path of json_doc, an empty path is the whole document\n";
+			out.format( "inline {} {}( std::string_view json_doc, std::string_view path = {{ }} ) {{\n",
+			            layout.columns_type,
+			            layout.columns_parser );
+			out.format( "\tauto result = {}{{ }};\n", layout.columns_type );
+			out.format( "\tfor( auto &&row : daw::json::json_array_range<{}>( json_doc, path ) ) {{\n",
+			            cur_obj.object_name );
+			for( std::size_t n = 0; n < layout.cold_begin; ++n ) {
+				out.format( "\t\tresult.{0}.push_back( std::move( row.{0} ) );\n", member_name( n ) );
+			}
+			if( layout.has_cold( ) ) {
+				out.format( "\t\tif( row.{} ) {{\n", layout.cold_member );
+				for( auto n = layout.cold_begin; n < layout.order.size( ); ++n ) {
+					out.format( "\t\t\tresult.{0}.push_back( std::move( row.{1}->{0} ) );\n",
+					            member_name( n ),
+					            layout.cold_member );
+				}
+				out << "\t\t} else {\n";
+				for( auto n = layout.cold_begin; n < layout.order.size( ); ++n ) {
+					out.format( "\t\t\tresult.{}.emplace_back( );\n", member_name( n ) );
+				}
+				out << "\t\t}\n";
+			}
+			out << "\t}\n\treturn result;\n}\n";
+		}
+
 		void generate_json_link_maps( std::integral_constant<int, 3>,
-		                              config_t &config,
-		                              types::ti_object const &cur_obj ) {
+		                              code_emitter_t &out,
+		                              config_t const &config,
+		                              types::ti_object const &cur_obj,
+		                              member_layout_t const &layout ) {
 			if( not config.enable_jsonlink ) {
 				return;
 			}
-			using daw::json::json_value_t;
-			config.cpp_file( ) << fmt::format( "namespace daw::json {{\n", cur_obj.object_name );
-			config.cpp_file( ) << fmt::format( "\ttemplate<>\n\tstruct json_data_contract<{}> {{\n",
-			                                   cur_obj.object_name );
+			out << "namespace daw::json {\n";
+			out.format( "\ttemplate<>\n\tstruct json_data_contract<{}> {{\n", cur_obj.object_name );
 			for( auto const &child : *cur_obj.children ) {
 				if( config.hide_null_only and is_null( child.second ) ) {
 					continue;
 				}
-				config.cpp_file( ) << fmt::format( "\t\tstatic constexpr char const mem_{}[] = \"",
-				                                   child.first );
+				out.format( "\t\tstatic constexpr char const mem_{}[] = \"", child.first );
 				auto child_name = daw::string_view( child.first.data( ), child.first.size( ) );
 				if( child_name.starts_with( "_json" ) ) {
 					child_name.remove_prefix( 5 );
 				}
-				config.cpp_file( ) << child_name << "\";\n";
+				out << child_name << "\";\n";
 			}
-			config.cpp_file( ) << "\t\t using type = json_member_list<\n";
+			// Members are constructed in the order of the list, which must be the
+			// order they are declared in
+			out << "\t\t using type = json_member_list<\n";
 
 			bool is_first = true;
 
-			for( auto const &child : *cur_obj.children ) {
-				if( config.hide_null_only and is_null( child.second ) ) {
-					continue;
-				}
-				config.cpp_file( ) << "\t\t\t\t";
+			for( auto const idx : layout.order ) {
+				auto const &child = cur_obj.children->begin( )[static_cast<std::ptrdiff_t>( idx )];
+				out << "\t\t\t\t";
 				if( not is_first ) {
-					config.cpp_file( ) << ",";
+					out << ",";
 				} else {
 					is_first = false;
 				}
 				if( is_optional( child.second ) ) {
-					config.cpp_file( ) << "json_nullable<";
+					out << "json_nullable<";
 				}
-				config.cpp_file( ) << types::ti_value( child.second )
-				                        .json_name( child.first, config.has_cpp20, cur_obj.object_name );
+				out << types::ti_value( child.second )
+				         .json_name( std::string( child.first ),
+				                     config.has_cpp20,
+				                     daw::string_view( cur_obj.object_name.data( ),
+				                                       cur_obj.object_name.size( ) ) );
 				if( is_optional( child.second ) ) {
-					config.cpp_file( ) << ">\n";
+					out << ">\n";
 				} else {
-					config.cpp_file( ) << '\n';
+					out << '\n';
 				}
 			}
-			config.cpp_file( ) << "\t>;\n\n";
+			out << "\t>;\n\n";
 
-			config.cpp_file( ) << "\t\tstatic inline auto to_json_data( " << cur_obj.object_name
-			                   << " const & value ) {\n";
-			config.cpp_file( ) << "\t\t\treturn std::forward_as_tuple( ";
-			is_first = true;
-			for( auto const &child : *cur_obj.children ) {
-				if( config.hide_null_only and is_null( child.second ) ) {
-					continue;
-				}
-				if( not is_first ) {
-					config.cpp_file( ) << ", ";
-				} else {
-					is_first = not is_first;
+			if( layout.has_cold( ) ) {
+				out.format( "\t\tstatic inline {} const & cold_members( {} const & value ) {{\n",
+				            layout.cold_type,
+				            cur_obj.object_name );
+				out.format( "\t\t\tstatic {} const empty{{ }};\n", layout.cold_type );
+				out.format( "\t\t\treturn value.{0} ? *value.{0} : empty;\n\t\t}}\n\n", layout.cold_member );
+			}
+			out << "\t\tstatic inline auto to_json_data( " << cur_obj.object_name
+			    << " const & value ) {\n";
+			out << "\t\t\treturn std::forward_as_tuple( ";
+			for( std::size_t n = 0; n < layout.order.size( ); ++n ) {
+				if( n != 0 ) {
+					out << ", ";
 				}
-				config.cpp_file( ) << "value." << child.first;
+				out << ( n < layout.cold_begin ? "value." : "cold_members( value )." )
+				    << cur_obj.children->begin( )[static_cast<std::ptrdiff_t>( layout.order[n] )].first;
+			}
+			out << " );\n}\n\t};\n}\n";
+			if( layout.has_columns( ) ) {
+				generate_columns_parser( out, cur_obj, layout );
 			}
-			config.cpp_file( ) << " );\n}\n\t};\n}\n";
 		}
 
-		void generate_json_link_maps( config_t &config, types::ti_object const &cur_obj ) {
+		void generate_json_link_maps( code_emitter_t &out,
+		                              config_t const &config,
+		                              types::ti_object const &cur_obj,
+		                              member_layout_t const &layout ) {
 
-			generate_json_link_maps( std::integral_constant<int, 3>( ), config, cur_obj );
+			generate_json_link_maps( std::integral_constant<int, 3>( ), out, config, cur_obj, layout );
 		}
 
-		void generate_includes( bool definition, config_t &config, state_t const &obj_state ) {
-			{
-				std::string const header_message =
-				  "// Code auto generated from json file '" + config.json_path.string( ) + "'\n\n";
-				if( not definition ) {
-					config.header_file( ) << header_message;
+		void generate_includes( bool definition,
+		                        code_emitter_t &out,
+		                        config_t const &config,
+		                        state_t const &obj_state ) {
+			if( not definition ) {
+				if( config.json_paths.size( ) == 1 ) {
+					out << "// Code auto generated from json file '"
+					    << config.json_paths.front( ).string( ) << "'\n\n";
+				} else {
+					out << "// Code auto generated from json files\n";
+					for( auto const &json_path : config.json_paths ) {
+						out << "//   '" << json_path.string( ) << "'\n";
+					}
+					out << '\n';
 				}
 			}
 			if( not definition ) {
-				config.header_file( ) << "#pragma once\n\n";
+				out << "#pragma once\n\n";
 				if( config.enable_jsonlink ) {
-					config.header_file( ) << "#include <tuple>\n";
+					out << "#include <tuple>\n";
 				}
 				if( obj_state.has_optionals ) {
-					config.header_file( ) << "#include <optional>\n";
+					out << "#include <optional>\n";
 				}
-				if( obj_state.has_integrals ) {
-					config.header_file( ) << "#include <cstdint>\n";
+				if( obj_state.has_cold_members ) {
+					out << "#include <memory>\n";
 				}
-				if( obj_state.has_strings ) {
-					if( config.use_string_view ) {
-						config.header_file( ) << "#include <string_view>\n";
-					} else {
-						config.header_file( ) << "#include <string>\n";
-					}
+				bool const has_columns_parser = obj_state.has_columns and config.enable_jsonlink;
+				if( obj_state.has_cold_members or has_columns_parser ) {
+					out << "#include <utility>\n";
+				}
+				if( obj_state.has_integrals or obj_state.has_enums ) {
+					out << "#include <cstdint>\n";
+				}
+				// The enum converters and the std::array constructor
+				bool const has_converters = obj_state.has_enums and config.enable_jsonlink;
+				bool const has_array_constructor = obj_state.has_fixed_arrays and config.enable_jsonlink;
+				if( obj_state.has_fixed_arrays ) {
+					out << "#include <array>\n";
+				}
+				if( has_array_constructor ) {
+					out << "#include <cstddef>\n";
+				}
+				if( has_converters or has_array_constructor ) {
+					out << "#include <stdexcept>\n";
+				}
+				if( ( obj_state.has_strings and not config.use_string_view ) or has_array_constructor ) {
+					out << "#include <string>\n";
+				}
+				if( ( obj_state.has_strings and config.use_string_view ) or has_converters or has_columns_parser ) {
+					out << "#include <string_view>\n";
 				}
 				if( obj_state.has_arrays ) {
-					config.header_file( ) << "#include <vector>\n";
+					out << "#include <vector>\n";
+				}
+				if( obj_state.has_small_vectors ) {
+					out << "#include <boost/container/small_vector.hpp>\n";
 				}
 				if( obj_state.has_kv ) {
-					config.header_file( ) << "#include <unordered_map>\n";
+					out << "#include <unordered_map>\n";
 				}
 				if( config.enable_jsonlink ) {
-					config.header_file( ) << "#include <daw/json/daw_json_link.h>\n";
+					out << "#include <daw/json/daw_json_link.h>\n";
+				}
+				out << '\n';
+			}
+		}
+
+		void generate_declaration( code_emitter_t &out,
+		                           types::ti_object const &cur_obj,
+		                           member_layout_t const &layout ) {
+			auto const obj_type = cur_obj.name( );
+			auto const member_at = [&]( std::size_t n ) -> auto const & {
+				return cur_obj.children->begin( )[static_cast<std::ptrdiff_t>( layout.order[n] )];
+			};
+			auto const member_type = [&]( std::size_t n ) {
+				auto const &child = member_at( n );
+				auto const type = types::ti_value( child.second ).name( );
+				if( is_optional( child.second ) ) {
+					return "std::optional<" + type + ">";
 				}
-				config.header_file( ) << '\n';
+				return type;
+			};
+			if( layout.has_cold( ) ) {
+				out << "struct " << layout.cold_type << " {\n";
+				for( auto n = layout.cold_begin; n < layout.order.size( ); ++n ) {
+					out << "\t" << member_type( n ) << " " << member_at( n ).first << ";\n";
+				}
+				out << "};"
+				    << "\t// " << layout.cold_type << "\n\n";
+			}
+			out << "struct " << obj_type << " {\n";
+			for( std::size_t n = 0; n < layout.cold_begin; ++n ) {
+				out << "\t" << member_type( n ) << " " << member_at( n ).first << ";\n";
+			}
+			if( layout.has_cold( ) ) {
+				// Takes the members in the order of the json_member_list, and only
+				// allocates the cold struct when one of its members is present
+				out << "\tstd::unique_ptr<" << layout.cold_type << "> " << layout.cold_member << ";\n\n";
+				out << "\t" << obj_type << "( ) = default;\n";
+				out << "\t" << obj_type << "( ";
+				for( std::size_t n = 0; n < layout.order.size( ); ++n ) {
+					if( n != 0 ) {
+						out << ", ";
+					}
+					out << member_type( n ) << " " << member_at( n ).first;
+				}
+				out << " )";
+				for( std::size_t n = 0; n < layout.cold_begin; ++n ) {
+					out << ( n == 0 ? "\n\t  : " : "\n\t  , " );
+					out.format( "{0}( std::move( {0} ) )", member_at( n ).first );
+				}
+				out << " {\n\t\tif( ";
+				for( auto n = layout.cold_begin; n < layout.order.size( ); ++n ) {
+					if( n != layout.cold_begin ) {
+						out << " or ";
+					}
+					out << member_at( n ).first;
+				}
+				out << " ) {\n";
+				out.format( "\t\t\t{} = std::make_unique<{}>( {}{{ ", layout.cold_member, layout.cold_type, layout.cold_type );
+				for( auto n = layout.cold_begin; n < layout.order.size( ); ++n ) {
+					if( n != layout.cold_begin ) {
+						out << ", ";
+					}
+					out.format( "std::move( {} )", member_at( n ).first );
+				}
+				out << " } );\n\t\t}\n\t}\n";
+				// Copies get their own cold struct, so the type stays copyable like
+				// one without a cold struct
+				out.format( "\n\t{0}( {0} const & other )", obj_type );
+				for( std::size_t n = 0; n < layout.cold_begin; ++n ) {
+					out << ( n == 0 ? "\n\t  : " : "\n\t  , " );
+					out.format( "{0}( other.{0} )", member_at( n ).first );
+				}
+				out << ( layout.cold_begin == 0 ? "\n\t  : " : "\n\t  , " );
+				out.format( "{0}( other.{0} ? std::make_unique<{1}>( *other.{0} ) : nullptr ) {{}}\n\n",
+				            layout.cold_member, layout.cold_type );
+				out.format( "\t{0}( {0} && ) = default;\n\n", obj_type );
+				out.format( "\t{0} & operator=( {0} const & other ) {{\n", obj_type );
+				out.format( "\t\t*this = {}( other );\n\t\treturn *this;\n\t}}\n\n", obj_type );
+				out.format( "\t{0} & operator=( {0} && ) = default;\n", obj_type );
 			}
+			out << "};"
+			    << "\t// " << obj_type << "\n\n";
+			if( layout.has_columns( ) ) {
+				// Element n of every column is member n of the same element
+				out << "struct " << layout.columns_type << " {\n";
+				for( std::size_t n = 0; n < layout.order.size( ); ++n ) {
+					out << "\tstd::vector<" << member_type( n ) << "> " << member_at( n ).first << ";\n";
+				}
+				out << "};"
+				    << "\t// " << layout.columns_type << "\n\n";
+			}
+		}
+
+		/// An enum class and the values of every string type that is named after
+		/// it
+		struct enum_info_t {
+			types::ti_string const *type;
+			std::vector<std::string_view> values;
+		};
+
+		template<typename Function>
+		void for_each_enum( types::ti_types_t const &value, Function const &func ) {
+			for_each_nested_type( value, [&]( types::ti_types_t const &type ) {
+				if( auto const *str = std::get_if<types::ti_string>( &type ); str != nullptr and str->is_enum( ) ) {
+					func( *str );
+				}
+			} );
 		}
 
-		void generate_declarations( std::vector<types::ti_object> const &obj_info, config_t &config ) {
-			for( auto const &cur_obj : obj_info ) {
-				auto const obj_type = cur_obj.name( );
-				config.header_file( ) << "struct " << obj_type << " {\n";
-				for( auto const &child : *cur_obj.children ) {
+		/// Find the containers other than std::vector that arrays are generated
+		/// as
+		void find_array_containers( std::vector<types::ti_object const *> const &obj_info,
+		                            config_t const &config,
+		                            state_t &obj_state ) {
+			for( auto const *cur_obj : obj_info ) {
+				for( auto const &child : *cur_obj->children ) {
 					if( config.hide_null_only and is_null( child.second ) ) {
 						continue;
 					}
-					auto const &member_name = child.first;
-					auto const &member_type = types::ti_value( child.second ).name( );
-					config.header_file( ) << "\t";
-					if( is_optional( child.second ) ) {
-						config.header_file( ) << "std::optional<" << member_type << ">";
-					} else {
-						config.header_file( ) << member_type;
+					for_each_nested_type( child.second, [&]( types::ti_types_t const &type ) {
+						if( auto const *arry = std::get_if<types::ti_array>( &type ) ) {
+							obj_state.has_fixed_arrays |= arry->is_fixed_size( );
+							obj_state.has_small_vectors |= arry->is_small_vector( );
+						}
+					} );
+				}
+			}
+		}
+
+		/// The constructor that json_array uses for std::array members
+		void generate_array_helpers( code_emitter_t &out, config_t const &config, state_t const &obj_state ) {
+			if( not obj_state.has_fixed_arrays or not config.enable_jsonlink ) {
+				return;
+			}
+			out << "template<typename T, std::size_t N>\n";
+			out << "struct fixed_array_constructor_t {\n";
+			out << "\tstd::array<T, N> operator( )( ) const {\n\t\treturn { };\n\t}\n\n";
+			out << "\ttemplate<typename Iterator>\n";
+			out << "\tstd::array<T, N> operator( )( Iterator first, Iterator last ) const {\n";
+			out << "\t\tauto result = std::array<T, N>{ };\n";
+			out << "\t\tstd::size_t n = 0;\n";
+			out << "\t\tfor( ; first != last and n < N; ++first ) {\n";
+			out << "\t\t\tresult[n++] = *first;\n\t\t}\n";
+			out << "\t\tif( n != N or first != last ) {\n";
+			out << "\t\t\tthrow std::invalid_argument( \"Expected an array of \" + std::to_string( N ) + \" elements\" );\n";
+			out << "\t\t}\n\t\treturn result;\n\t}\n";
+			out << "};"
+			    << "\t// fixed_array_constructor_t\n\n";
+		}
+
+		/// Call func for every string in value and the element types nested in
+		/// it.  The members of objects are not visited
+		template<typename Function>
+		void for_each_string( types::ti_types_t &value, Function const &func ) {
+			if( auto *str = std::get_if<types::ti_string>( &value ) ) {
+				func( *str );
+			} else if( auto *arry = std::get_if<types::ti_array>( &value ); arry != nullptr and arry->children != nullptr ) {
+				for( auto &child : *arry->children ) {
+					for_each_string( child.second, func );
+				}
+			} else if( auto *kv = std::get_if<types::ti_kv>( &value ); kv != nullptr and kv->value != nullptr ) {
+				for( auto &child : *kv->value ) {
+					for_each_string( child.second, func );
+				}
+			}
+		}
+
+		/// Give every enum a name that no struct and no other enum has.  An enum
+		/// stem is the owner and the member joined by _, so owner a_b with member
+		/// c and owner a with member b_c get the same one, and so can a struct.
+		/// The enums of one object with the same stem stay one enum, any other
+		/// clash adds a number like enumerator_names does.  Run again after a
+		/// merge, it keeps the names that do not clash
+		void make_enum_names_unique( object_registry_t &obj_info, types::ti_arena &arena ) {
+			// The names of the structs and of the types generated for them
+			auto taken = std::unordered_set<std::string>( );
+			for( auto const &obj : obj_info ) {
+				auto const stem = std::string( obj.object_name.substr( 0, obj.object_name.rfind( "_t" ) ) );
+				taken.insert( std::string( obj.object_name ) );
+				taken.insert( stem + "_cold_t" );
+				taken.insert( stem + "_columns_t" );
+			}
+			// The object each enum stem was given to
+			auto owners = std::unordered_map<std::string_view, std::string_view>( );
+			for( auto &obj : obj_info ) {
+				auto renames = std::unordered_map<std::string_view, std::string_view>( );
+				for( auto &child : *obj.children ) {
+					for_each_string( child.second, [&]( types::ti_string &str ) {
+						if( not str.is_enum( ) ) {
+							return;
+						}
+						if( auto const pos = renames.find( str.enum_stem ); pos != renames.end( ) ) {
+							str.enum_stem = pos->second;
+							return;
+						}
+						auto stem = std::string( str.enum_stem );
+						for( std::size_t n = 2;; ++n ) {
+							if( auto const pos = owners.find( stem ); pos != owners.end( ) ) {
+								if( pos->second == obj.object_name ) {
+									break;
+								}
+							} else if( taken.count( stem + "_t" ) == 0 and taken.count( stem + "_converter_t" ) == 0 ) {
+								break;
+							}
+							stem = std::string( str.enum_stem ) + "_" + std::to_string( n );
+						}
+						auto const unique_stem = arena.intern( stem );
+						if( owners.try_emplace( unique_stem, obj.object_name ).second ) {
+							taken.insert( stem + "_t" );
+							taken.insert( stem + "_converter_t" );
+						}
+						renames.emplace( str.enum_stem, unique_stem );
+						str.enum_stem = unique_stem;
+					} );
+				}
+			}
+		}
+
+		/// The enums used by the members of the objects, in the order they are
+		/// first used.  Strings that end up with the same enum name share one
+		/// enum with the values of both
+		std::vector<enum_info_t> collect_enums( std::vector<types::ti_object const *> const &obj_info,
+		                                        config_t const &config ) {
+			auto result = std::vector<enum_info_t>( );
+			auto index = std::unordered_map<std::string_view, std::size_t>( );
+			for( auto const *cur_obj : obj_info ) {
+				for( auto const &child : *cur_obj->children ) {
+					if( config.hide_null_only and is_null( child.second ) ) {
+						continue;
 					}
-					config.header_file( ) << " " << member_name << ";\n";
+					for_each_enum( child.second, [&]( types::ti_string const &str ) {
+						auto const [pos, is_new] = index.try_emplace( str.enum_stem, result.size( ) );
+						if( is_new ) {
+							result.push_back( enum_info_t{ &str, { } } );
+						}
+						auto &values = result[pos->second].values;
+						for( auto const &value : str.values->values ) {
+							if( std::find( values.begin( ), values.end( ), value ) == values.end( ) ) {
+								values.push_back( value );
+							}
+						}
+					} );
 				}
-				config.header_file( ) << "};"
-				                      << "\t// " << obj_type << "\n\n";
 			}
+			return result;
 		}
 
-		void generate_definitions( std::vector<types::ti_object> const &obj_info, config_t &config ) {
+		/// \return An enumerator for each value.  Characters that cannot be in
+		/// an identifier become _, and a number is added to names that are
+		/// already taken
+		std::vector<std::string> enumerator_names( std::vector<std::string_view> const &values ) {
+			auto result = std::vector<std::string>( );
+			result.reserve( values.size( ) );
+			for( auto const &value : values ) {
+				auto name = std::string( value );
+				for( auto &c : name ) {
+					if( std::isalnum( static_cast<unsigned char>( c ) ) == 0 ) {
+						c = '_';
+					}
+				}
+				name = make_compliant_names( std::move( name ) );
+				auto unique_name = name;
+				for( std::size_t n = 2; std::find( result.begin( ), result.end( ), unique_name ) != result.end( );
+				     ++n ) {
+					unique_name = name + "_" + std::to_string( n );
+				}
+				result.push_back( std::move( unique_name ) );
+			}
+			return result;
+		}
+
+		void generate_enum( code_emitter_t &out, config_t const &config, enum_info_t const &info ) {
+			auto const enum_type = info.type->enum_name( );
+			auto const names = enumerator_names( info.values );
+			out.format( "enum class {} : {} {{\n", enum_type, enum_underlying_type( names.size( ) ) );
+			for( std::size_t n = 0; n < names.size( ); ++n ) {
+				out << "\t" << names[n] << ( n + 1U < names.size( ) ? ",\n" : "\n" );
+			}
+			out << "};"
+			    << "\t// " << enum_type << "\n\n";
 			if( not config.enable_jsonlink ) {
 				return;
 			}
-			for( auto const &cur_obj : obj_info ) {
-				generate_json_link_maps( config, cur_obj );
+			// Unknown strings are an error when parsing, like any other value of
+			// the wrong type
+			auto const converter_type = info.type->converter_name( );
+			out << "struct " << converter_type << " {\n";
+			out.format( "\t{} operator( )( std::string_view value ) const {{\n", enum_type );
+			for( std::size_t n = 0; n < names.size( ); ++n ) {
+				out << "\t\tif( value == \"" << info.values[n] << "\" ) {\n";
+				out.format( "\t\t\treturn {}::{};\n\t\t}}\n", enum_type, names[n] );
 			}
+			out.format( "\t\tthrow std::invalid_argument( \"Unknown {} value\" );\n\t}}\n\n", enum_type );
+			out.format( "\tstd::string_view operator( )( {} value ) const {{\n", enum_type );
+			out << "\t\tswitch( value ) {\n";
+			for( std::size_t n = 0; n < names.size( ); ++n ) {
+				out.format( "\t\tcase {}::{}:\n", enum_type, names[n] );
+				out << "\t\t\treturn \"" << info.values[n] << "\";\n";
+			}
+			out << "\t\t}\n\t\treturn { };\n\t}\n";
+			out << "};"
+			    << "\t// " << converter_type << "\n\n";
 		}
 
-		void generate_code( std::vector<types::ti_object> const &obj_info,
-		                    config_t &config,
-		                    state_t const &obj_state ) {
-			generate_includes( true, config, obj_state );
-			generate_includes( false, config, obj_state );
-			generate_declarations( obj_info, config );
-			generate_definitions( obj_info, config );
+		void generate_enums( std::vector<enum_info_t> const &enums,
+		                     code_emitter_t &out,
+		                     config_t const &config ) {
+			for( auto const &info : enums ) {
+				generate_enum( out, config, info );
+			}
+		}
+
+		/// Call render( out, obj ) for every object.  Schemas with more than
+		/// block_size objects are rendered on all cores, block_size objects per
+		/// task, into separate buffers.  These are then appended in order so the
+		/// output does not depend on the thread count
+		template<typename Render>
+		void render_objects( std::vector<types::ti_object const *> const &obj_info,
+		                     std::size_t block_size,
+		                     code_emitter_t &out,
+		                     Render const &render ) {
+			auto const task_count = ( obj_info.size( ) + block_size - 1 ) / block_size;
+			if( task_count <= 1 ) {
+				for( auto const *cur_obj : obj_info ) {
+					render( out, *cur_obj );
+				}
+				return;
+			}
+			auto parts = std::vector<code_emitter_t>( task_count );
+			parallel_for( task_count, [&]( std::size_t task ) {
+				auto const first = task * block_size;
+				auto const last = std::min( first + block_size, obj_info.size( ) );
+				for( auto n = first; n < last; ++n ) {
+					render( parts[task], *obj_info[n] );
+				}
+			} );
+			for( auto const &part : parts ) {
+				out.append( part );
+			}
+		}
+
+		void generate_declarations( std::vector<types::ti_object const *> const &obj_info,
+		                            code_emitter_t &out,
+		                            config_t const &config,
+		                            member_layouts_t const &layouts ) {
+			auto const render = [&]( code_emitter_t &part, types::ti_object const &cur_obj ) {
+				generate_declaration( part, cur_obj, layouts.at( cur_obj.object_name ) );
+			};
+			render_objects( obj_info, config.render_block_size, out, render );
+		}
+
+		void generate_definitions( std::vector<types::ti_object const *> const &obj_info,
+		                           code_emitter_t &out,
+		                           config_t const &config,
+		                           member_layouts_t const &layouts ) {
+			if( not config.enable_jsonlink ) {
+				return;
+			}
+			auto const render = [&]( code_emitter_t &part, types::ti_object const &cur_obj ) {
+				generate_json_link_maps( part, config, cur_obj, layouts.at( cur_obj.object_name ) );
+			};
+			render_objects( obj_info, config.render_block_size, out, render );
+		}
+
+		bool has_cold_members( member_layouts_t const &layouts ) {
+			return std::any_of( layouts.begin( ), layouts.end( ), []( auto const &layout ) {
+				return layout.second.has_cold( );
+			} );
+		}
+
+		bool has_columns( member_layouts_t const &layouts ) {
+			return std::any_of( layouts.begin( ), layouts.end( ), []( auto const &layout ) {
+				return layout.second.has_columns( );
+			} );
+		}
+
+		template<typename Function>
+		void for_each_object_dependency( types::ti_types_t const &value, Function const &func ) {
+			daw::visit_nt(
+			  value,
+			  [&]( types::ti_object const &obj ) { func( obj.name( ) ); },
+			  [&]( types::ti_array const &arry ) {
+				  if( arry.children != nullptr ) {
+					  for( auto const &child : *arry.children ) {
+						  for_each_object_dependency( child.second, func );
+					  }
+				  }
+			  },
+			  [&]( types::ti_kv const &kv ) {
+				  if( kv.value != nullptr ) {
+					  for( auto const &child : *kv.value ) {
+						  for_each_object_dependency( child.second, func );
+					  }
+				  }
+			  },
+			  []( auto const & ) {} );
+		}
+
+		/// Order the objects so that every object comes after the types of its
+		/// members.  Objects are otherwise kept in the order they were first seen
+		std::vector<types::ti_object const *> dependency_order( object_registry_t const &obj_info ) {
+			auto result = std::vector<types::ti_object const *>( );
+			result.reserve( obj_info.size( ) );
+			auto visited = std::vector<bool>( obj_info.size( ), false );
+			auto const visit = [&]( auto const &self, std::size_t idx ) -> void {
+				if( visited[idx] ) {
+					return;
+				}
+				visited[idx] = true;
+				for( auto const &child : *obj_info[idx].children ) {
+					for_each_object_dependency( child.second, [&]( std::string const &dep_name ) {
+						if( auto const dep = obj_info.find_index( dep_name ); dep != object_registry_t::npos ) {
+							self( self, dep );
+						}
+					} );
+				}
+				result.push_back( &obj_info[idx] );
+			};
+			for( std::size_t n = 0; n < obj_info.size( ); ++n ) {
+				visit( visit, n );
+			}
+			return result;
+		}
+
+		bool has_optional_members( object_registry_t const &obj_info ) {
+			return std::any_of( obj_info.begin( ), obj_info.end( ), []( auto const &obj ) {
+				return std::any_of( obj.children->begin( ), obj.children->end( ), []( auto const &child ) {
+					return is_optional( child.second );
+				} );
+			} );
 		}
 	} // namespace
 
@@ -490,10 +1547,228 @@ namespace daw::json_to_cpp {
 		return *cpp_stream;
 	}
 
+	schema_t infer_schema( daw::string_view json_string, config_t const &config ) {
+		auto source = string_source( json_string );
+		return infer_schema( source, config );
+	}
+
+	schema_t infer_schema( json_source &source, config_t const &config ) {
+		auto result = schema_t( );
+		auto &arena = *result.arenas.emplace_back( std::make_unique<types::ti_arena>( ) );
+		auto parser = json_event_parser( source );
+		auto identifiers = identifier_table_t( arena );
+		auto handler = inference_handler( result.obj_info, result.state, arena, identifiers, config );
+		parser.parse_document( handler );
+		make_enum_names_unique( result.obj_info, arena );
+		result.identifier_stats = identifiers.stats( );
+		return result;
+	}
+
+	schema_t infer_ndjson_schema( json_source &source, config_t const &config ) {
+		auto result = schema_t( );
+		auto &arena = *result.arenas.emplace_back( std::make_unique<types::ti_arena>( ) );
+		auto parser = json_event_parser( source );
+		auto identifiers = identifier_table_t( arena );
+		auto handler = inference_handler( result.obj_info, result.state, arena, identifiers, config );
+		while( parser.parse_value( handler ) ) {}
+		make_enum_names_unique( result.obj_info, arena );
+		result.identifier_stats = identifiers.stats( );
+		return result;
+	}
+
+	void merge_schema( schema_t &lhs, schema_t rhs ) {
+		lhs.state.has_arrays |= rhs.state.has_arrays;
+		lhs.state.has_integrals |= rhs.state.has_integrals;
+		lhs.state.has_optionals |= rhs.state.has_optionals;
+		lhs.state.has_strings |= rhs.state.has_strings;
+		lhs.state.has_kv |= rhs.state.has_kv;
+		lhs.obj_info.add_stats( rhs.obj_info.stats( ) );
+		lhs.identifier_stats += rhs.identifier_stats;
+		// The types of rhs are copied by reference, so its arenas must live as
+		// long as lhs
+		std::move( rhs.arenas.begin( ), rhs.arenas.end( ), std::back_inserter( lhs.arenas ) );
+		for( auto const &obj : rhs.obj_info ) {
+			lhs.obj_info.add_or_merge( obj, merge_object );
+		}
+		// The objects of rhs can clash with the enums of lhs and the other way
+		// around
+		if( not lhs.arenas.empty( ) ) {
+			make_enum_names_unique( lhs.obj_info, *lhs.arenas.back( ) );
+		}
+	}
+
+	schema_t merge_schemas( std::vector<schema_t> schemas ) {
+		if( schemas.empty( ) ) {
+			return schema_t( );
+		}
+		// Each pass merges neighbours that are stride apart, so the left side
+		// always holds the earlier documents and first seen order is kept
+		for( std::size_t stride = 1; stride < schemas.size( ); stride *= 2 ) {
+			auto const pair_count = ( schemas.size( ) + ( 2 * stride ) - 1 ) / ( 2 * stride );
+			parallel_for( pair_count, [&]( std::size_t n ) {
+				auto const lhs = n * 2 * stride;
+				auto const rhs = lhs + stride;
+				if( rhs < schemas.size( ) ) {
+					merge_schema( schemas[lhs], std::move( schemas[rhs] ) );
+				}
+			} );
+		}
+		return std::move( schemas.front( ) );
+	}
+
+	void generate_code( schema_t const &schema, config_t &config ) {
+		// Merging instances can make members optional that were never null
+		auto obj_state = schema.state;
+		obj_state.has_optionals |= has_optional_members( schema.obj_info );
+		auto const obj_info = dependency_order( schema.obj_info );
+		auto const enums = collect_enums( obj_info, config );
+		obj_state.has_enums = not enums.empty( );
+		auto const layouts = plan_layouts( obj_info, config );
+		obj_state.has_cold_members = has_cold_members( layouts );
+		obj_state.has_columns = has_columns( layouts );
+		find_array_containers( obj_info, config, obj_state );
+		auto header = code_emitter_t( );
+		auto cpp = code_emitter_t( );
+		generate_includes( true, cpp, config, obj_state );
+		generate_includes( false, header, config, obj_state );
+		generate_array_helpers( header, config, obj_state );
+		generate_enums( enums, header, config );
+		generate_declarations( obj_info, header, config, layouts );
+		generate_definitions( obj_info, cpp, config, layouts );
+		// The header comes first when both go to the same stream
+		header.flush_to( config.header_file( ) );
+		cpp.flush_to( config.cpp_file( ) );
+	}
+
+	void generate_declarations( schema_t const &schema, config_t &config ) {
+		auto header = code_emitter_t( );
+		auto const obj_info = dependency_order( schema.obj_info );
+		generate_enums( collect_enums( obj_info, config ), header, config );
+		generate_declarations( obj_info, header, config, plan_layouts( obj_info, config ) );
+		header.flush_to( config.header_file( ) );
+	}
+
+	void generate_definitions( schema_t const &schema, config_t &config ) {
+		auto cpp = code_emitter_t( );
+		auto const obj_info = dependency_order( schema.obj_info );
+		generate_definitions( obj_info, cpp, config, plan_layouts( obj_info, config ) );
+		cpp.flush_to( config.cpp_file( ) );
+	}
+
+	std::vector<generated_file_t>
+	generate_sharded_code( schema_t const &schema, config_t const &config, std::size_t shard_size ) {
+		if( shard_size == 0 ) {
+			shard_size = 1;
+		}
+		auto obj_state = schema.state;
+		obj_state.has_optionals |= has_optional_members( schema.obj_info );
+		auto const obj_info = dependency_order( schema.obj_info );
+		auto const enums = collect_enums( obj_info, config );
+		obj_state.has_enums = not enums.empty( );
+		auto const layouts = plan_layouts( obj_info, config );
+		obj_state.has_cold_members = has_cold_members( layouts );
+		obj_state.has_columns = has_columns( layouts );
+		find_array_containers( obj_info, config, obj_state );
+		auto const shard_count = ( obj_info.size( ) + shard_size - 1 ) / shard_size;
+		auto const &root_name = config.root_object_name;
+		auto const shard_name = [&]( std::size_t shard ) {
+			if( shard_size == 1 ) {
+				return obj_info[shard]->name( ) + ".h";
+			}
+			return fmt::format( "{}_{}.h", root_name, shard );
+		};
+		auto shard_of = std::unordered_map<std::string_view, std::size_t>( );
+		for( std::size_t n = 0; n < obj_info.size( ); ++n ) {
+			shard_of.emplace( obj_info[n]->object_name, n / shard_size );
+		}
+
+		auto result = std::vector<generated_file_t>( );
+		result.reserve( shard_count + 2 );
+		auto const fwd_name = root_name + "_fwd.h";
+		{
+			auto out = code_emitter_t( );
+			out << "#pragma once\n\n";
+			// Enums are members by value, so every shard needs their definition,
+			// as does the mapping of every std::array
+			bool const has_array_constructor = obj_state.has_fixed_arrays and config.enable_jsonlink;
+			if( not enums.empty( ) or has_array_constructor ) {
+				if( has_array_constructor ) {
+					out << "#include <array>\n#include <cstddef>\n";
+				}
+				if( not enums.empty( ) ) {
+					out << "#include <cstdint>\n";
+				}
+				if( config.enable_jsonlink ) {
+					out << "#include <stdexcept>\n";
+				}
+				if( has_array_constructor ) {
+					out << "#include <string>\n";
+				}
+				if( config.enable_jsonlink and not enums.empty( ) ) {
+					out << "#include <string_view>\n";
+				}
+				out << '\n';
+				generate_array_helpers( out, config, obj_state );
+				generate_enums( enums, out, config );
+			}
+			for( auto const *cur_obj : obj_info ) {
+				out << "struct " << cur_obj->object_name << ";\n";
+			}
+			result.push_back( generated_file_t{ fwd_name, std::string( out.view( ) ) } );
+		}
+		auto shards = std::vector<generated_file_t>( shard_count );
+		auto const render_shard = [&]( std::size_t shard ) {
+			auto const first = shard * shard_size;
+			auto const last = std::min( first + shard_size, obj_info.size( ) );
+			auto const types =
+			  std::vector<types::ti_object const *>( std::next( obj_info.begin( ), first ),
+			                                          std::next( obj_info.begin( ), last ) );
+			// Members are held by value, so the shards of their types are needed
+			auto deps = std::vector<std::size_t>( );
+			for( auto const *cur_obj : types ) {
+				for( auto const &child : *cur_obj->children ) {
+					for_each_object_dependency( child.second, [&]( std::string const &dep_name ) {
+						auto const pos = shard_of.find( dep_name );
+						if( pos != shard_of.end( ) and pos->second != shard ) {
+							deps.push_back( pos->second );
+						}
+					} );
+				}
+			}
+			std::sort( deps.begin( ), deps.end( ) );
+			deps.erase( std::unique( deps.begin( ), deps.end( ) ), deps.end( ) );
+
+			auto out = code_emitter_t( );
+			generate_includes( false, out, config, obj_state );
+			out << "#include \"" << fwd_name << "\"\n";
+			for( auto dep : deps ) {
+				out << "#include \"" << shard_name( dep ) << "\"\n";
+			}
+			out << '\n';
+			generate_declarations( types, out, config, layouts );
+			generate_definitions( types, out, config, layouts );
+			shards[shard] = generated_file_t{ shard_name( shard ), std::string( out.view( ) ) };
+		};
+		if( shard_size > config.render_block_size ) {
+			// Large shards are already rendered in parallel
+			for( std::size_t shard = 0; shard < shard_count; ++shard ) {
+				render_shard( shard );
+			}
+		} else {
+			parallel_for( shard_count, render_shard );
+		}
+		auto umbrella = code_emitter_t( );
+		umbrella << "#pragma once\n\n";
+		umbrella << "#include \"" << fwd_name << "\"\n";
+		for( auto &shard : shards ) {
+			umbrella << "#include \"" << shard.name << "\"\n";
+			result.push_back( std::move( shard ) );
+		}
+		result.push_back( generated_file_t{ root_name + ".h", std::string( umbrella.view( ) ) } );
+		return result;
+	}
+
 	void generate_cpp( daw::string_view json_string, config_t &config ) {
-		auto obj_state = state_t( );
-		auto json_obj = daw::json::parse_json( json_string );
-		auto obj_info = parse_json_object( json_obj, obj_state, config );
-		generate_code( obj_info, config, obj_state );
+		generate_code( infer_schema( json_string, config ), config );
 	}
 } // namespace daw::json_to_cpp
@@ -6,20 +6,39 @@
 // Official repository: https://github.com/beached/daw_json_link
 //
 
+#include <algorithm>
+#include <atomic>
 #include <boost/program_options.hpp>
+#include <condition_variable>
+#include <cstdint>
 #include <cstdlib>
+#include <deque>
+#include <exception>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include <daw/daw_string_view.h>
 
 #include "curl_t.h"
+#include "decoding_source.h"
+#include "json_events.h"
+#include "json_source.h"
 #include "json_to_cpp.h"
+#include "mapped_file.h"
+#include "parallel.h"
+#include "schema_cache.h"
+#include "schema_snapshot.h"
 
 namespace {
 	// Paths are specified with dot separators, if the name has a dot in it,
@@ -60,6 +79,459 @@ namespace {
 		}
 		return result;
 	}
+
+	std::optional<daw::json_to_cpp::array_sampling_t> parse_array_sampling( std::string const &name ) {
+		using daw::json_to_cpp::array_sampling_t;
+		if( name == "all" ) {
+			return array_sampling_t::all;
+		}
+		if( name == "first_n" ) {
+			return array_sampling_t::first_n;
+		}
+		if( name == "reservoir" ) {
+			return array_sampling_t::reservoir;
+		}
+		if( name == "until_stable" ) {
+			return array_sampling_t::until_stable;
+		}
+		return std::nullopt;
+	}
+
+	/// "-" names stdin
+	bool is_stdin( std::filesystem::path const &path ) {
+		return path == "-";
+	}
+
+	bool has_glob_chars( std::string const &path ) {
+		return path.find_first_of( "*?[" ) != std::string::npos;
+	}
+
+	/// \return true if name matches pattern as in a shell.  * matches any run of
+	/// characters, ? any one character and [...] one of a set of characters,
+	/// which is negated by a leading ! or ^
+	bool matches_glob( std::string_view pattern, std::string_view name ) {
+		std::size_t p = 0;
+		std::size_t n = 0;
+		// Where to continue when the text after the last * does not match
+		auto star_p = std::string_view::npos;
+		std::size_t star_n = 0;
+		auto const match_set = [&]( char c, std::size_t &pos ) -> std::optional<bool> {
+			auto end = pos + 1U;
+			bool const negated = end < pattern.size( ) and ( pattern[end] == '!' or pattern[end] == '^' );
+			if( negated ) {
+				++end;
+			}
+			auto const first = end;
+			bool is_match = false;
+			// A ] right after the opening [ is part of the set
+			while( end < pattern.size( ) and ( pattern[end] != ']' or end == first ) ) {
+				if( end + 2U < pattern.size( ) and pattern[end + 1U] == '-' and pattern[end + 2U] != ']' ) {
+					is_match |= pattern[end] <= c and c <= pattern[end + 2U];
+					end += 3U;
+				} else {
+					is_match |= pattern[end] == c;
+					++end;
+				}
+			}
+			if( end == pattern.size( ) ) {
+				// Without a closing ] the [ is matched as itself
+				return std::nullopt;
+			}
+			pos = end + 1U;
+			return is_match != negated;
+		};
+		while( n < name.size( ) ) {
+			if( p < pattern.size( ) and pattern[p] == '*' ) {
+				star_p = ++p;
+				star_n = n;
+				continue;
+			}
+			if( p < pattern.size( ) ) {
+				if( pattern[p] == '[' ) {
+					auto next = p;
+					if( auto const is_match = match_set( name[n], next ) ) {
+						if( *is_match ) {
+							p = next;
+							++n;
+							continue;
+						}
+					} else if( name[n] == '[' ) {
+						++p;
+						++n;
+						continue;
+					}
+				} else if( pattern[p] == '?' or pattern[p] == name[n] ) {
+					++p;
+					++n;
+					continue;
+				}
+			}
+			if( star_p == std::string_view::npos ) {
+				return false;
+			}
+			p = star_p;
+			n = ++star_n;
+		}
+		while( p < pattern.size( ) and pattern[p] == '*' ) {
+			++p;
+		}
+		return p == pattern.size( );
+	}
+
+	/// \return The paths that match pattern, sorted.  Each part of the pattern
+	/// with glob characters is matched against the entries of the directories
+	/// matched so far.  As in a shell, files starting with . are only matched
+	/// by a part that starts with .
+	std::vector<std::filesystem::path> expand_glob( std::string const &pattern ) {
+		auto const pattern_path = std::filesystem::path( pattern );
+		auto matches = std::vector<std::filesystem::path>{ pattern_path.root_path( ) };
+		for( auto const &part : pattern_path.relative_path( ) ) {
+			auto const part_pattern = part.string( );
+			auto next = std::vector<std::filesystem::path>( );
+			for( auto const &dir : matches ) {
+				auto ec = std::error_code( );
+				if( not has_glob_chars( part_pattern ) ) {
+					if( auto path = dir / part; std::filesystem::exists( path, ec ) ) {
+						next.push_back( std::move( path ) );
+					}
+					continue;
+				}
+				auto const search_dir = dir.empty( ) ? std::filesystem::path( "." ) : dir;
+				for( auto const &entry : std::filesystem::directory_iterator( search_dir, ec ) ) {
+					auto const name = entry.path( ).filename( ).string( );
+					if( ( name.front( ) != '.' or part_pattern.front( ) == '.' ) and matches_glob( part_pattern, name ) ) {
+						next.push_back( dir / name );
+					}
+				}
+			}
+			matches = std::move( next );
+		}
+		std::sort( matches.begin( ), matches.end( ) );
+		return matches;
+	}
+
+	void add_directory( std::filesystem::path const &dir, std::vector<std::filesystem::path> &result ) {
+		auto found = std::vector<std::filesystem::path>( );
+		for( auto const &entry : std::filesystem::recursive_directory_iterator( dir ) ) {
+			if( entry.is_regular_file( ) and entry.path( ).extension( ) == ".json" ) {
+				found.push_back( entry.path( ) );
+			}
+		}
+		// Directory iteration order is unspecified, keep the output stable
+		std::sort( found.begin( ), found.end( ) );
+		result.insert( result.end( ), found.begin( ), found.end( ) );
+	}
+
+	/// Expand the in_file arguments into a list of inputs.  Globs are expanded
+	/// and directories are searched recursively for .json files
+	std::vector<std::filesystem::path> expand_inputs( std::vector<std::string> const &inputs ) {
+		auto result = std::vector<std::filesystem::path>( );
+		bool has_stdin = false;
+		for( auto const &input : inputs ) {
+			if( is_stdin( input ) ) {
+				if( std::exchange( has_stdin, true ) ) {
+					throw std::runtime_error( "stdin can only be read once" );
+				}
+				result.emplace_back( input );
+			} else if( daw::curl::is_url( input ) ) {
+				result.emplace_back( input );
+			} else if( has_glob_chars( input ) ) {
+				auto matches = expand_glob( input );
+				if( matches.empty( ) ) {
+					throw std::runtime_error( "No files match '" + input + "'" );
+				}
+				for( auto &match : matches ) {
+					if( is_directory( match ) ) {
+						add_directory( match, result );
+					} else {
+						result.push_back( std::move( match ) );
+					}
+				}
+			} else if( std::filesystem::is_directory( input ) ) {
+				add_directory( input, result );
+			} else if( exists( std::filesystem::path( input ) ) ) {
+				result.emplace_back( input );
+			} else {
+				throw std::runtime_error( "Could not file file '" + input + "'" );
+			}
+		}
+		if( result.empty( ) ) {
+			throw std::runtime_error( "No json input files found" );
+		}
+		return result;
+	}
+
+	/// Read a file of urls, one per line.  Blank lines and lines starting with
+	/// # are skipped
+	std::vector<std::string> read_url_list( std::filesystem::path const &path ) {
+		auto in = std::ifstream( path );
+		if( not in ) {
+			throw std::runtime_error( "Could not open url_list '" + path.string( ) + "'" );
+		}
+		auto result = std::vector<std::string>( );
+		auto line = std::string( );
+		while( std::getline( in, line ) ) {
+			auto const first = line.find_first_not_of( " \t\r" );
+			if( first == std::string::npos or line[first] == '#' ) {
+				continue;
+			}
+			auto const last = line.find_last_not_of( " \t\r" );
+			auto url = line.substr( first, last + 1 - first );
+			if( not daw::curl::is_url( url ) ) {
+				throw std::runtime_error( "'" + url + "' in url_list '" + path.string( ) +
+				                          "' is not a http or https url" );
+			}
+			result.push_back( std::move( url ) );
+		}
+		return result;
+	}
+
+	/// The bytes of one input, mapped from a file, or downloaded or read from
+	/// stdin
+	struct input_data_t {
+		daw::json_to_cpp::mapped_file_t file{ };
+		std::optional<std::string> buffer{ };
+
+		daw::string_view view( ) const noexcept {
+			if( buffer ) {
+				return daw::string_view( buffer->data( ), buffer->size( ) );
+			}
+			return file.view( );
+		}
+	};
+
+	/// Map or read a local input, urls are downloaded by url_fetch_t
+	void load_input( std::filesystem::path const &input, input_data_t &data ) {
+		auto const p = input.string( );
+		if( is_stdin( input ) ) {
+			auto source = daw::json_to_cpp::file_source( stdin );
+			data.buffer.emplace( );
+			for( auto chunk = source.next_chunk( ); not chunk.empty( ); chunk = source.next_chunk( ) ) {
+				data.buffer->append( chunk.data( ), chunk.size( ) );
+			}
+		} else if( not data.file.open( input ) ) {
+			throw std::runtime_error( "Could not open json in_file '" + p + "'" );
+		}
+	}
+
+	/// Infer the types of raw, which may be compressed
+	daw::json_to_cpp::schema_t infer_source( daw::json_to_cpp::json_source &raw,
+	                                         daw::json_to_cpp::config_t const &config ) {
+		auto source = daw::json_to_cpp::decoding_source( raw );
+		if( config.ndjson ) {
+			return daw::json_to_cpp::infer_ndjson_schema( source, config );
+		}
+		return daw::json_to_cpp::infer_schema( source, config );
+	}
+
+	daw::json_to_cpp::schema_t infer_input( std::filesystem::path const &input,
+	                                        input_data_t const &data,
+	                                        daw::json_to_cpp::config_t const &config ) {
+		try {
+			auto source = daw::json_to_cpp::string_source( data.view( ) );
+			return infer_source( source, config );
+		} catch( daw::json_to_cpp::json_parse_error const &parse_error ) {
+			throw std::runtime_error( input.string( ) + ": " + parse_error.what( ) );
+		}
+	}
+
+	/// Feed a local input to inference in chunks as it is read, without
+	/// holding all of it in memory
+	daw::json_to_cpp::schema_t infer_streamed_input( std::filesystem::path const &input,
+	                                                 daw::json_to_cpp::config_t const &config ) {
+		auto const p = input.string( );
+		try {
+			if( is_stdin( input ) ) {
+				auto source = daw::json_to_cpp::file_source( stdin );
+				return infer_source( source, config );
+			}
+			auto source = daw::json_to_cpp::file_source( input );
+			if( not source ) {
+				throw std::runtime_error( "Could not open json in_file '" + p + "'" );
+			}
+			return infer_source( source, config );
+		} catch( daw::json_to_cpp::json_parse_error const &parse_error ) {
+			throw std::runtime_error( p + ": " + parse_error.what( ) );
+		}
+	}
+
+	/// Downloads the url inputs on a thread of its own, with the transfers
+	/// sharing connections.  Each is handed out as soon as its transfer starts,
+	/// so that it is parsed while it downloads rather than after the slowest
+	/// one has finished
+	class url_fetch_t {
+		std::vector<std::filesystem::path> const *m_paths;
+		// Only the url inputs have a stream
+		std::vector<std::unique_ptr<daw::curl::body_stream_t>> m_streams;
+		std::mutex m_lock{ };
+		std::condition_variable m_started{ };
+		// The inputs whose transfer started and were not handed out by next yet
+		std::deque<std::size_t> m_ready{ };
+		bool m_done = false;
+		std::exception_ptr m_error{ };
+		std::atomic<bool> m_cancelled = false;
+		std::thread m_thread{ };
+
+		void fetch( std::vector<std::size_t> indices,
+		            std::string user_agent,
+		            std::size_t max_connections ) {
+			try {
+				auto urls = std::vector<std::string>( );
+				urls.reserve( indices.size( ) );
+				for( auto const index : indices ) {
+					urls.push_back( ( *m_paths )[index].string( ) );
+				}
+				daw::curl::download_all(
+				  urls, user_agent, max_connections,
+				  [&]( std::size_t n ) -> daw::curl::body_stream_t & {
+					  auto const index = indices[n];
+					  auto const lck = std::lock_guard<std::mutex>( m_lock );
+					  m_ready.push_back( index );
+					  m_started.notify_one( );
+					  return *m_streams[index];
+				  },
+				  &m_cancelled );
+			} catch( ... ) {
+				auto const lck = std::lock_guard<std::mutex>( m_lock );
+				m_error = std::current_exception( );
+			}
+			auto const lck = std::lock_guard<std::mutex>( m_lock );
+			m_done = true;
+			m_started.notify_all( );
+		}
+
+	public:
+		/// Start downloading paths[indices].  Only capacity bytes of a body that
+		/// is_streamed are held at a time, the others are held whole
+		template<typename Predicate>
+		url_fetch_t( std::vector<std::filesystem::path> const &paths,
+		             std::vector<std::size_t> indices,
+		             Predicate is_streamed,
+		             std::string user_agent,
+		             std::size_t max_connections )
+		  : m_paths( &paths )
+		  , m_streams( paths.size( ) ) {
+			for( auto const index : indices ) {
+				m_streams[index] = std::make_unique<daw::curl::body_stream_t>(
+				  is_streamed( index ) ? daw::curl::body_stream_t::default_capacity
+				                       : daw::curl::body_stream_t::unbounded );
+			}
+			m_thread = std::thread( [this, indices = std::move( indices ),
+			                         user_agent = std::move( user_agent ), max_connections]( ) mutable {
+				fetch( std::move( indices ), std::move( user_agent ), max_connections );
+			} );
+		}
+
+		~url_fetch_t( ) {
+			m_cancelled = true;
+			m_thread.join( );
+		}
+
+		url_fetch_t( url_fetch_t const & ) = delete;
+		url_fetch_t( url_fetch_t && ) = delete;
+		url_fetch_t &operator=( url_fetch_t const & ) = delete;
+		url_fetch_t &operator=( url_fetch_t && ) = delete;
+
+		/// Wait for a download to start that has not been handed out yet
+		/// \return The index in paths of the download
+		std::size_t next( ) {
+			auto lck = std::unique_lock<std::mutex>( m_lock );
+			m_started.wait( lck, [&] { return not m_ready.empty( ) or m_done; } );
+			if( m_ready.empty( ) ) {
+				if( m_error ) {
+					std::rethrow_exception( m_error );
+				}
+				throw std::runtime_error( "More downloads were expected" );
+			}
+			auto const index = m_ready.front( );
+			m_ready.pop_front( );
+			return index;
+		}
+
+		daw::curl::body_stream_t &stream( std::size_t index ) {
+			return *m_streams[index];
+		}
+
+		/// Wait for the whole body of paths[index]
+		/// \throws std::runtime_error if the download failed
+		std::string body( std::size_t index ) {
+			auto result = m_streams[index]->read_all( );
+			if( not result ) {
+				throw std::runtime_error( "Could not download json data from '" +
+				                          ( *m_paths )[index].string( ) + "'" );
+			}
+			return std::move( *result );
+		}
+	};
+
+	/// A download that is parsed while it arrives
+	class body_source final : public daw::json_to_cpp::json_source {
+		daw::curl::body_stream_t *m_stream;
+		std::filesystem::path const *m_url;
+
+	public:
+		body_source( daw::curl::body_stream_t &stream, std::filesystem::path const &url )
+		  : m_stream( &stream )
+		  , m_url( &url ) {}
+
+		// Lets the transfer finish if parsing stopped early
+		~body_source( ) override {
+			m_stream->close( );
+		}
+
+		daw::string_view next_chunk( ) override {
+			auto const chunk = m_stream->read( );
+			if( chunk.empty( ) and not m_stream->is_ok( ) ) {
+				throw std::runtime_error( "Could not download json data from '" + m_url->string( ) + "'" );
+			}
+			return chunk;
+		}
+	};
+
+	daw::json_to_cpp::schema_t infer_fetched_input( std::filesystem::path const &url,
+	                                                daw::curl::body_stream_t &stream,
+	                                                daw::json_to_cpp::config_t const &config ) {
+		try {
+			auto source = body_source( stream, url );
+			return infer_source( source, config );
+		} catch( daw::json_to_cpp::json_parse_error const &parse_error ) {
+			throw std::runtime_error( url.string( ) + ": " + parse_error.what( ) );
+		}
+	}
+
+	daw::json_to_cpp::schema_t load_snapshot( std::filesystem::path const &path,
+	                                          input_data_t const &data ) {
+		auto const view = data.view( );
+		auto result = daw::json_to_cpp::deserialize_schema( std::string_view( view.data( ), view.size( ) ) );
+		if( not result ) {
+			throw std::runtime_error( "'" + path.string( ) + "' is not a schema snapshot of format version " +
+			                          std::to_string( daw::json_to_cpp::schema_format_version ) );
+		}
+		return std::move( *result );
+	}
+
+	struct cache_stats_t {
+		std::atomic<std::size_t> schema_hits = 0;
+		std::atomic<std::size_t> schema_misses = 0;
+		bool output_hit = false;
+	};
+
+	void write_shards( std::filesystem::path const &directory,
+	                   std::vector<daw::json_to_cpp::generated_file_t> const &files,
+	                   bool allow_overwrite ) {
+		std::filesystem::create_directories( directory );
+		for( auto const &file : files ) {
+			auto const path = directory / file.name;
+			if( exists( path ) and not allow_overwrite ) {
+				throw std::runtime_error( "output file '" + path.string( ) + "' already exists" );
+			}
+			auto out = std::ofstream( path, std::ios::out | std::ios::trunc | std::ios::binary );
+			out.write( file.content.data( ), static_cast<std::streamsize>( file.content.size( ) ) );
+			if( not out ) {
+				throw std::runtime_error( "Could not write '" + path.string( ) + "'" );
+			}
+		}
+	}
 } // namespace
 
 int main( int argc, char **argv ) {
@@ -70,8 +542,14 @@ int main( int argc, char **argv ) {
 	boost::program_options::options_description desc{ "Options" };
 	desc.add_options( )( "help", "print option descriptions" )(
 	  "in_file",
+	  boost::program_options::value<std::vector<std::string>>( )->multitoken( ),
+	  "json source file paths, globs, directories or urls" )(
+	  "url_list",
 	  boost::program_options::value<std::filesystem::path>( ),
-	  "json source file path or url" )( "kv_paths",
+	  "File with a json source url on each line" )(
+	  "max_connections",
+	  boost::program_options::value<std::size_t>( )->default_value( 8 ),
+	  "Maximum number of urls downloaded at the same time" )( "kv_paths",
 	                                    boost::program_options::value<std::vector<std::string>>( ),
 	                                    "Specify class members that are key value pairs" )(
 	  "use_jsonlink",
@@ -82,10 +560,31 @@ int main( int argc, char **argv ) {
 	  "Enables use of non-type class template arguments" )(
 	  "output_file",
 	  boost::program_options::value<std::filesystem::path>( ),
-	  "output goes to c++ header file." )(
+	  "output goes to c++ header file.  Cannot be used with shard_dir" )(
+	  "shard_dir",
+	  boost::program_options::value<std::filesystem::path>( ),
+	  "Write a header per shard_size types, a forward declaration header and "
+	  "an umbrella header to this directory instead of one header" )(
+	  "shard_size",
+	  boost::program_options::value<std::size_t>( )->default_value( 1 ),
+	  "Number of types in each header of shard_dir" )(
 	  "allow_overwrite",
 	  boost::program_options::value<bool>( )->default_value( false ),
 	  "Overwrite existing output files" )(
+	  "load_snapshot",
+	  boost::program_options::value<std::vector<std::filesystem::path>>( )->multitoken( ),
+	  "Schema snapshots to merge with the in_file samples" )(
+	  "save_snapshot",
+	  boost::program_options::value<std::filesystem::path>( ),
+	  "Save the merged schema to this file" )(
+	  "cache_dir",
+	  boost::program_options::value<std::filesystem::path>( ),
+	  "Reuse the schemas and output of earlier runs with the same inputs and "
+	  "options, stored in this directory" )(
+	  "ndjson",
+	  boost::program_options::value<bool>( )->default_value( false ),
+	  "Each input is a stream of JSON values, such as NDJSON / JSON Lines, "
+	  "that are each an instance of the root object" )(
 	  "hide_null_only",
 	  boost::program_options::value<bool>( )->default_value( true ),
 	  "Do not output json entries that are only ever null" )(
@@ -99,11 +598,66 @@ int main( int argc, char **argv ) {
 	  "user_agent",
 	  boost::program_options::value<std::string>( )->default_value(
 	    static_cast<std::string>( default_user_agent ) ),
-	  "User agent to use when downloading via URL" );
+	  "User agent to use when downloading via URL" )(
+	  "array_sampling",
+	  boost::program_options::value<std::string>( )->default_value( "all" ),
+	  "Which array elements are used to infer the element type: all, first_n, "
+	  "reservoir or until_stable" )(
+	  "sample_count",
+	  boost::program_options::value<std::size_t>( )->default_value( 100 ),
+	  "Number of elements for first_n and reservoir sampling, or the number of "
+	  "unchanged elements in a row before until_stable stops" )(
+	  "sample_seed",
+	  boost::program_options::value<std::uint64_t>( )->default_value( 0 ),
+	  "Seed for reservoir sampling" )(
+	  "narrow_numbers",
+	  boost::program_options::value<bool>( )->default_value( false ),
+	  "Use the smallest integer type that holds the values seen, and float "
+	  "for reals that are all exact as a float" )(
+	  "narrow_margin_bits",
+	  boost::program_options::value<std::size_t>( )->default_value( 1 ),
+	  "Extra bits of range for narrowed integers, each doubles the range "
+	  "beyond the values seen" )(
+	  "enum_max_values",
+	  boost::program_options::value<std::size_t>( )->default_value( 0 ),
+	  "Generate an enum class for strings with at most this many distinct "
+	  "values, 0 disables enums" )(
+	  "fixed_array_max",
+	  boost::program_options::value<std::size_t>( )->default_value( 0 ),
+	  "Use std::array for arrays that always had the same length, up to this "
+	  "length, 0 disables it" )(
+	  "small_vector_max",
+	  boost::program_options::value<std::size_t>( )->default_value( 0 ),
+	  "Use boost::container::small_vector for arrays never longer than this, "
+	  "0 disables it" )(
+	  "optimize_layout",
+	  boost::program_options::value<bool>( )->default_value( false ),
+	  "Order struct members by alignment and size, required members first, "
+	  "to avoid padding" )(
+	  "cold_member_ratio",
+	  boost::program_options::value<double>( )->default_value( 0.0 ),
+	  "Move optional members present in fewer than this share of the "
+	  "instances into a separately allocated struct, 0 disables it" )(
+	  "struct_of_arrays",
+	  boost::program_options::value<bool>( )->default_value( false ),
+	  "Also generate a struct of arrays, with a parser that fills it, for "
+	  "array elements with only scalar members" )(
+	  "render_block_size",
+	  boost::program_options::value<std::size_t>( )->default_value( 64 ),
+	  "Types generated by one task when there are more than this and they "
+	  "are generated on several cores" )(
+	  "print_stats",
+	  boost::program_options::value<bool>( )->default_value( false ),
+	  "Print type inference statistics to stderr" );
 
 	auto vm = boost::program_options::variables_map( );
 	try {
-		boost::program_options::store( boost::program_options::parse_command_line( argc, argv, desc ),
+		auto positional = boost::program_options::positional_options_description( );
+		positional.add( "in_file", -1 );
+		boost::program_options::store( boost::program_options::command_line_parser( argc, argv )
+		                                 .options( desc )
+		                                 .positional( positional )
+		                                 .run( ),
 		                               vm );
 		if( vm.count( "help" ) ) {
 			std::cout << "Command line options\n" << desc << std::endl;
@@ -117,71 +671,256 @@ int main( int argc, char **argv ) {
 	}
 	auto config = daw::json_to_cpp::config_t( );
 
-	if( not vm.count( "in_file" ) ) {
+	auto snapshot_paths = std::vector<std::filesystem::path>( );
+	if( vm.count( "load_snapshot" ) > 0 ) {
+		snapshot_paths = vm["load_snapshot"].as<std::vector<std::filesystem::path>>( );
+	}
+	if( not vm.count( "in_file" ) and not vm.count( "url_list" ) and snapshot_paths.empty( ) ) {
 		std::cerr << "Missing in_file parameter\n";
 		exit( EXIT_FAILURE );
 	}
-	config.json_path = vm["in_file"].as<std::filesystem::path>( );
+	try {
+		auto in_files = std::vector<std::string>( );
+		if( vm.count( "in_file" ) > 0 ) {
+			in_files = vm["in_file"].as<std::vector<std::string>>( );
+		}
+		if( vm.count( "url_list" ) > 0 ) {
+			auto urls = read_url_list( vm["url_list"].as<std::filesystem::path>( ) );
+			in_files.insert( in_files.end( ), std::make_move_iterator( urls.begin( ) ),
+			                 std::make_move_iterator( urls.end( ) ) );
+		}
+		if( not in_files.empty( ) ) {
+			config.json_paths = expand_inputs( in_files );
+		}
+	} catch( std::runtime_error const &input_error ) {
+		std::cerr << input_error.what( ) << '\n';
+		std::cerr << "Command line options\n" << desc << std::endl;
+		exit( EXIT_FAILURE );
+	}
 	config.root_object_name = vm["root_object"].as<std::string>( );
 
 	if( vm.count( "kv_paths" ) > 0 ) {
 		config.kv_paths = process_paths( vm["kv_paths"].as<std::vector<std::string>>( ) );
 	}
 
-	auto const json_str = [&]( ) {
-		if( auto const p = config.json_path.string( ); daw::curl::is_url( p ) ) {
-			auto tmp = daw::curl::download( p, vm["user_agent"].as<std::string>( ) );
-			if( not tmp ) {
-				std::cerr << "Could not download json data from '" << canonical( config.json_path )
-				          << "'\n";
-				exit( EXIT_FAILURE );
-			}
-			return *tmp;
-		} else {
-			if( not exists( config.json_path ) ) {
-				std::cerr << "Could not file file '" << config.json_path << "'\n";
-				std::cerr << "Command line options\n" << desc << std::endl;
-				exit( EXIT_FAILURE );
-			}
-
-			auto in_file = std::ifstream( config.json_path.string( ) );
-			if( not in_file ) {
-				std::cerr << "Could not open json in_file '" << canonical( config.json_path ) << "'\n";
-				exit( EXIT_FAILURE );
-			}
-			auto tmp = std::string( );
-			std::copy( std::istream_iterator<char>( in_file ),
-			           std::istream_iterator<char>( ),
-			           std::back_inserter( tmp ) );
-			return tmp;
-		}
-	}( );
-
 	config.cpp_stream = &std::cout;
 	config.header_stream = &std::cout;
 	config.enable_jsonlink = vm["use_jsonlink"].as<bool>( );
 	config.hide_null_only = vm["hide_null_only"].as<bool>( );
 	config.use_string_view = vm["use_string_view"].as<bool>( );
 	config.has_cpp20 = vm["has_cpp20"].as<bool>( );
+	if( auto const sampling = parse_array_sampling( vm["array_sampling"].as<std::string>( ) ) ) {
+		config.array_sampling = *sampling;
+	} else {
+		std::cerr << "Unknown array_sampling '" << vm["array_sampling"].as<std::string>( ) << "'\n";
+		exit( EXIT_FAILURE );
+	}
+	config.sample_count = vm["sample_count"].as<std::size_t>( );
+	if( config.sample_count == 0 and config.array_sampling != daw::json_to_cpp::array_sampling_t::all ) {
+		std::cerr << "sample_count must be greater than 0\n";
+		exit( EXIT_FAILURE );
+	}
+	config.sample_seed = vm["sample_seed"].as<std::uint64_t>( );
+	config.narrow_numbers = vm["narrow_numbers"].as<bool>( );
+	config.narrow_margin_bits = vm["narrow_margin_bits"].as<std::size_t>( );
+	config.enum_max_values = vm["enum_max_values"].as<std::size_t>( );
+	config.fixed_array_max = vm["fixed_array_max"].as<std::size_t>( );
+	config.small_vector_max = vm["small_vector_max"].as<std::size_t>( );
+	config.optimize_layout = vm["optimize_layout"].as<bool>( );
+	config.cold_member_ratio = vm["cold_member_ratio"].as<double>( );
+	config.struct_of_arrays = vm["struct_of_arrays"].as<bool>( );
+	config.render_block_size = vm["render_block_size"].as<std::size_t>( );
+	if( config.render_block_size == 0 ) {
+		std::cerr << "render_block_size must be greater than 0\n";
+		exit( EXIT_FAILURE );
+	}
+	if( not( config.cold_member_ratio >= 0.0 and config.cold_member_ratio <= 1.0 ) ) {
+		std::cerr << "cold_member_ratio must be between 0 and 1\n";
+		exit( EXIT_FAILURE );
+	}
+	auto const max_connections = vm["max_connections"].as<std::size_t>( );
+	if( max_connections == 0 ) {
+		std::cerr << "max_connections must be greater than 0\n";
+		exit( EXIT_FAILURE );
+	}
+	if( vm["shard_size"].as<std::size_t>( ) == 0 ) {
+		std::cerr << "shard_size must be greater than 0\n";
+		exit( EXIT_FAILURE );
+	}
+	// The shards replace the one header, output_file would be left empty
+	if( vm.count( "output_file" ) > 0 and vm.count( "shard_dir" ) > 0 ) {
+		std::cerr << "output_file and shard_dir cannot be used together\n";
+		exit( EXIT_FAILURE );
+	}
+	config.ndjson = vm["ndjson"].as<bool>( );
 	auto cpp_file = std::ofstream( );
 	auto header_file = std::ofstream( );
 
-	if( vm.count( "cpp_file" ) > 0 ) {
-		bool const allow_overwrite = vm["allow_overwrite"].as<bool>( );
-		config.cpp_path = canonical( vm["output_file"].as<std::filesystem::path>( ) );
+	bool const allow_overwrite = vm["allow_overwrite"].as<bool>( );
+	if( vm.count( "output_file" ) > 0 ) {
+		config.cpp_path = std::filesystem::absolute( vm["output_file"].as<std::filesystem::path>( ) );
 		if( exists( config.cpp_path ) and not allow_overwrite ) {
-			std::cerr << "output_file '" << config.cpp_path << "' already exists\n";
+			std::cerr << "output_file '" << config.cpp_path.string( ) << "' already exists\n";
 			exit( EXIT_FAILURE );
 		}
 		cpp_file.open( config.cpp_path.string( ), std::ios::out | std::ios::trunc );
 		if( not cpp_file ) {
-			std::cerr << "Could not open cpp_file '" << config.cpp_path << "' for writing\n";
+			std::cerr << "Could not open output_file '" << config.cpp_path.string( ) << "' for writing\n";
 			exit( EXIT_FAILURE );
 		}
 		config.cpp_stream = &cpp_file;
 		config.header_stream = &cpp_file;
 	}
-	daw::json_to_cpp::generate_cpp( json_str, config );
+	try {
+		// Each input is inferred on its own, then the results are merged.  The
+		// snapshots come first and are loaded instead of inferred
+		daw::curl::global_init( );
+		auto const user_agent = vm["user_agent"].as<std::string>( );
+		auto input_paths = snapshot_paths;
+		input_paths.insert( input_paths.end( ), config.json_paths.begin( ), config.json_paths.end( ) );
+		auto const input_count = input_paths.size( );
+		auto const is_snapshot = [&]( std::size_t n ) {
+			return n < snapshot_paths.size( );
+		};
+		auto const is_fetched = [&]( std::size_t n ) {
+			return daw::curl::is_url( input_paths[n].string( ) );
+		};
+		bool const use_cache = vm.count( "cache_dir" ) > 0;
+		// Files are memory mapped unless they are streamed.  The cache keys need
+		// all of an input before it is parsed, so nothing is streamed then
+		auto const is_streamed = [&]( std::size_t n ) {
+			return not is_snapshot( n ) and not is_fetched( n ) and not use_cache and
+			       ( config.ndjson or is_stdin( input_paths[n] ) );
+		};
+		auto inputs = std::vector<input_data_t>( input_count );
+		// Local inputs are inferred first so that no thread waits on a download
+		// while there is other work
+		auto order = std::vector<std::size_t>( );
+		auto fetched = std::vector<std::size_t>( );
+		for( std::size_t n = 0; n < input_count; ++n ) {
+			( is_fetched( n ) ? fetched : order ).push_back( n );
+		}
+		order.insert( order.end( ), fetched.begin( ), fetched.end( ) );
+		auto fetch = std::optional<url_fetch_t>( );
+		// The cache keys and the snapshots need whole bodies, the rest are parsed
+		// as they arrive
+		auto const is_fetch_streamed = [&]( std::size_t n ) {
+			return not is_snapshot( n ) and not use_cache;
+		};
+		if( not fetched.empty( ) ) {
+			fetch.emplace( input_paths, fetched, is_fetch_streamed, user_agent, max_connections );
+		}
+		daw::json_to_cpp::parallel_for( input_count, [&]( std::size_t n ) {
+			if( not is_streamed( n ) and not is_fetched( n ) ) {
+				load_input( input_paths[n], inputs[n] );
+			}
+		} );
+		auto cache = std::optional<daw::json_to_cpp::schema_cache_t>( );
+		auto cache_stats = cache_stats_t( );
+		auto input_keys = std::vector<std::uint64_t>( input_count );
+		auto output_key = daw::json_to_cpp::hash_output_config( config );
+		bool const is_sharded = vm.count( "shard_dir" ) > 0;
+		if( use_cache ) {
+			for( auto const n : fetched ) {
+				inputs[n].buffer = fetch->body( n );
+			}
+			cache.emplace( vm["cache_dir"].as<std::filesystem::path>( ) );
+			auto const config_key = daw::json_to_cpp::hash_inference_config( config );
+			daw::json_to_cpp::parallel_for( input_count, [&]( std::size_t n ) {
+				auto const data = inputs[n].view( );
+				input_keys[n] =
+				  daw::json_to_cpp::hash_bytes( std::string_view( data.data( ), data.size( ) ), config_key );
+			} );
+			for( auto const key : input_keys ) {
+				output_key = daw::json_to_cpp::hash_bytes(
+				  std::string_view( reinterpret_cast<char const *>( &key ), sizeof( key ) ), output_key );
+			}
+			// A stored header is only enough when nothing else is written
+			if( not is_sharded and vm.count( "save_snapshot" ) == 0 ) {
+				if( auto const output = cache->load_output( output_key ) ) {
+					cache_stats.output_hit = true;
+					config.header_file( ).write( output->data( ),
+					                             static_cast<std::streamsize>( output->size( ) ) );
+				}
+			}
+		}
+		if( not cache_stats.output_hit ) {
+			auto schemas = std::vector<daw::json_to_cpp::schema_t>( input_count );
+			daw::json_to_cpp::parallel_for( input_count, [&]( std::size_t slot ) {
+				auto n = order[slot];
+				// Downloads are taken in the order they start
+				if( is_fetched( n ) ) {
+					n = fetch->next( );
+					if( is_fetch_streamed( n ) ) {
+						schemas[n] = infer_fetched_input( input_paths[n], fetch->stream( n ), config );
+						return;
+					}
+					if( not inputs[n].buffer ) {
+						inputs[n].buffer = fetch->body( n );
+					}
+				}
+				if( is_snapshot( n ) ) {
+					schemas[n] = load_snapshot( input_paths[n], inputs[n] );
+					return;
+				}
+				if( cache ) {
+					if( auto cached = cache->load_schema( input_keys[n] ) ) {
+						++cache_stats.schema_hits;
+						schemas[n] = std::move( *cached );
+						return;
+					}
+					++cache_stats.schema_misses;
+				}
+				if( is_streamed( n ) ) {
+					schemas[n] = infer_streamed_input( input_paths[n], config );
+					return;
+				}
+				schemas[n] = infer_input( input_paths[n], inputs[n], config );
+				if( cache ) {
+					cache->store_schema( input_keys[n], schemas[n] );
+				}
+			} );
+			auto const schema = daw::json_to_cpp::merge_schemas( std::move( schemas ) );
+			if( vm.count( "save_snapshot" ) > 0 ) {
+				daw::json_to_cpp::save_schema_snapshot( vm["save_snapshot"].as<std::filesystem::path>( ),
+				                                        schema );
+			}
+			if( is_sharded ) {
+				write_shards( vm["shard_dir"].as<std::filesystem::path>( ),
+				              daw::json_to_cpp::generate_sharded_code(
+				                schema, config, vm["shard_size"].as<std::size_t>( ) ),
+				              allow_overwrite );
+			} else if( cache ) {
+				// Render to memory so that the output can be stored as well as written
+				auto output = std::ostringstream( );
+				auto *const header_stream = config.header_stream;
+				config.header_stream = &output;
+				config.cpp_stream = &output;
+				daw::json_to_cpp::generate_code( schema, config );
+				auto const text = output.str( );
+				cache->store_output( output_key, text );
+				header_stream->write( text.data( ), static_cast<std::streamsize>( text.size( ) ) );
+			} else {
+				daw::json_to_cpp::generate_code( schema, config );
+			}
+			if( vm["print_stats"].as<bool>( ) ) {
+				auto const &stats = schema.obj_info.stats( );
+				std::cerr << "object registry: " << schema.obj_info.size( ) << " types, " << stats.hits
+				          << " hits, " << stats.misses << " misses, " << stats.inserts << " inserts, "
+				          << stats.merges << " merges\n";
+				std::cerr << "identifiers: " << schema.identifier_stats.hits << " hits, "
+				          << schema.identifier_stats.misses << " misses\n";
+			}
+		}
+		if( cache and vm["print_stats"].as<bool>( ) ) {
+			std::cerr << "cache: output " << ( cache_stats.output_hit ? "hit" : "miss" ) << ", "
+			          << cache_stats.schema_hits << " schema hits, " << cache_stats.schema_misses
+			          << " schema misses\n";
+		}
+	} catch( std::runtime_error const &error ) {
+		std::cerr << "ERROR: " << error.what( ) << '\n';
+		return EXIT_FAILURE;
+	}
 
 	return EXIT_SUCCESS;
 }
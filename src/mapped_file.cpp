@@ -0,0 +1,117 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#if __has_include( <sys/mman.h> )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define JSON_TO_CPP_HAS_MMAP
+#endif
+
+#include "mapped_file.h"
+
+namespace daw::json_to_cpp {
+	mapped_file_t::mapped_file_t( std::filesystem::path const &path ) {
+		open( path );
+	}
+
+	mapped_file_t::~mapped_file_t( ) {
+		close( );
+	}
+
+	void mapped_file_t::close( ) noexcept {
+#if defined( JSON_TO_CPP_HAS_MMAP )
+		if( m_is_mapped ) {
+			::munmap( const_cast<char *>( m_data ), m_size );
+		}
+#endif
+		m_data = nullptr;
+		m_size = 0;
+		m_is_mapped = false;
+		m_buffer.clear( );
+	}
+
+#if defined( JSON_TO_CPP_HAS_MMAP )
+	bool mapped_file_t::open( std::filesystem::path const &path ) {
+		close( );
+		int const fd = ::open( path.c_str( ), O_RDONLY );
+		if( fd < 0 ) {
+			return false;
+		}
+		struct ::stat st { };
+		if( ::fstat( fd, &st ) != 0 ) {
+			::close( fd );
+			return false;
+		}
+		if( S_ISREG( st.st_mode ) ) {
+			m_size = static_cast<std::size_t>( st.st_size );
+			if( m_size == 0 ) {
+				// mmap does not allow empty mappings
+				m_data = m_buffer.data( );
+				::close( fd );
+				return true;
+			}
+			void *ptr = ::mmap( nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+			::close( fd );
+			if( ptr == MAP_FAILED ) {
+				m_size = 0;
+				return false;
+			}
+			::madvise( ptr, m_size, MADV_SEQUENTIAL );
+			m_data = static_cast<char const *>( ptr );
+			m_is_mapped = true;
+			return true;
+		}
+		// Pipes and the like have no size up front, read them in large blocks
+		constexpr std::size_t block_size = 1024U * 1024U;
+		while( true ) {
+			auto const old_size = m_buffer.size( );
+			m_buffer.resize( old_size + block_size );
+			auto const count = ::read( fd, m_buffer.data( ) + old_size, block_size );
+			if( count < 0 ) {
+				::close( fd );
+				m_buffer.clear( );
+				return false;
+			}
+			m_buffer.resize( old_size + static_cast<std::size_t>( count ) );
+			if( count == 0 ) {
+				break;
+			}
+		}
+		::close( fd );
+		m_data = m_buffer.data( );
+		m_size = m_buffer.size( );
+		return true;
+	}
+#else
+	bool mapped_file_t::open( std::filesystem::path const &path ) {
+		close( );
+		auto in_file = std::ifstream( path, std::ios::binary );
+		if( not in_file ) {
+			return false;
+		}
+		in_file.seekg( 0, std::ios::end );
+		m_buffer.resize( static_cast<std::size_t>( in_file.tellg( ) ) );
+		in_file.seekg( 0, std::ios::beg );
+		in_file.read( m_buffer.data( ), static_cast<std::streamsize>( m_buffer.size( ) ) );
+		if( not in_file ) {
+			m_buffer.clear( );
+			return false;
+		}
+		m_data = m_buffer.data( );
+		m_size = m_buffer.size( );
+		return true;
+	}
+#endif
+} // namespace daw::json_to_cpp
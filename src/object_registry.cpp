@@ -0,0 +1,58 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <daw/daw_string_view.h>
+
+#include "object_registry.h"
+
+namespace daw::json_to_cpp {
+	std::size_t object_registry_t::find_index( daw::string_view name ) const {
+		auto pos = m_index.find( std::string_view( name.data( ), name.size( ) ) );
+		if( pos == m_index.end( ) ) {
+			return npos;
+		}
+		return pos->second;
+	}
+
+	std::size_t object_registry_t::counted_index( daw::string_view name ) {
+		auto const idx = find_index( name );
+		if( idx == npos ) {
+			++m_stats.misses;
+		} else {
+			++m_stats.hits;
+		}
+		return idx;
+	}
+
+	types::ti_object *object_registry_t::find( daw::string_view name ) {
+		auto const idx = find_index( name );
+		if( idx == npos ) {
+			return nullptr;
+		}
+		return &m_objects[idx];
+	}
+
+	types::ti_object const *object_registry_t::find( daw::string_view name ) const {
+		auto const idx = find_index( name );
+		if( idx == npos ) {
+			return nullptr;
+		}
+		return &m_objects[idx];
+	}
+
+	void object_registry_t::insert( types::ti_object &&obj ) {
+		++m_stats.inserts;
+		m_index.emplace( obj.object_name, m_objects.size( ) );
+		m_objects.push_back( std::move( obj ) );
+	}
+} // namespace daw::json_to_cpp
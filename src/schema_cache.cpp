@@ -0,0 +1,179 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <fmt/core.h>
+
+#include "schema_cache.h"
+#include "schema_snapshot.h"
+
+namespace daw::json_to_cpp {
+	namespace {
+		constexpr std::uint64_t hash_prime = 0x100000001b3ULL;
+		constexpr std::uint64_t hash_offset = 0xcbf29ce484222325ULL;
+
+		std::uint64_t hash_value( std::uint64_t h, std::uint64_t value ) noexcept {
+			return hash_bytes( std::string_view( reinterpret_cast<char const *>( &value ), sizeof( value ) ),
+			                   h );
+		}
+
+		std::uint64_t hash_real( std::uint64_t h, double value ) noexcept {
+			return hash_bytes( std::string_view( reinterpret_cast<char const *>( &value ), sizeof( value ) ),
+			                   h );
+		}
+
+		std::uint64_t hash_string( std::uint64_t h, std::string_view str ) noexcept {
+			// The length keeps "ab", "c" apart from "a", "bc"
+			return hash_bytes( str, hash_value( h, str.size( ) ) );
+		}
+	} // namespace
+
+	std::uint64_t hash_bytes( std::string_view data, std::uint64_t seed ) noexcept {
+		// FNV-1a over 64 bit words instead of bytes, with an extra shift to
+		// spread the high bits of each word
+		auto h = hash_offset ^ seed;
+		std::size_t n = 0;
+		for( ; n + sizeof( std::uint64_t ) <= data.size( ); n += sizeof( std::uint64_t ) ) {
+			std::uint64_t word;
+			std::memcpy( &word, data.data( ) + n, sizeof( word ) );
+			h = ( h ^ word ) * hash_prime;
+			h ^= h >> 32U;
+		}
+		for( ; n < data.size( ); ++n ) {
+			h = ( h ^ static_cast<std::uint8_t>( data[n] ) ) * hash_prime;
+		}
+		h = ( h ^ data.size( ) ) * hash_prime;
+		return h ^ ( h >> 29U );
+	}
+
+	std::uint64_t hash_inference_config( config_t const &config ) {
+		auto h = hash_value( hash_offset, schema_format_version );
+		h = hash_string( h, config.root_object_name );
+		h = hash_value( h, config.kv_paths.size( ) );
+		for( auto const &kv_path : config.kv_paths ) {
+			h = hash_value( h, kv_path.size( ) );
+			for( auto const &part : kv_path ) {
+				h = hash_string( h, part );
+			}
+		}
+		h = hash_value( h, static_cast<std::uint64_t>( config.array_sampling ) );
+		h = hash_value( h, config.sample_count );
+		h = hash_value( h, config.sample_seed );
+		h = hash_value( h, config.narrow_numbers );
+		h = hash_value( h, config.narrow_margin_bits );
+		h = hash_value( h, config.enum_max_values );
+		h = hash_value( h, config.fixed_array_max );
+		h = hash_value( h, config.small_vector_max );
+		h = hash_value( h, config.ndjson );
+		return hash_value( h, config.use_string_view );
+	}
+
+	std::uint64_t hash_output_config( config_t const &config ) {
+		auto h = hash_inference_config( config );
+		h = hash_value( h, config.enable_jsonlink );
+		h = hash_value( h, config.hide_null_only );
+		h = hash_value( h, config.has_cpp20 );
+		h = hash_string( h, config.type_prefix );
+		h = hash_string( h, config.type_suffix );
+		h = hash_value( h, config.optimize_layout );
+		h = hash_real( h, config.cold_member_ratio );
+		h = hash_value( h, config.struct_of_arrays );
+		// The paths are written in the header comment
+		h = hash_value( h, config.json_paths.size( ) );
+		for( auto const &json_path : config.json_paths ) {
+			h = hash_string( h, json_path.string( ) );
+		}
+		return h;
+	}
+
+	schema_cache_t::schema_cache_t( std::filesystem::path directory )
+	  : m_directory( std::move( directory ) ) {}
+
+	std::filesystem::path schema_cache_t::entry_path( std::uint64_t key,
+	                                                  char const *extension ) const {
+		return m_directory / fmt::format( "{:016x}{}", key, extension );
+	}
+
+	std::optional<std::string> schema_cache_t::load( std::uint64_t key,
+	                                                 char const *extension ) const {
+		auto in = std::ifstream( entry_path( key, extension ), std::ios::binary );
+		if( not in ) {
+			return std::nullopt;
+		}
+		auto result =
+		  std::string( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>( ) );
+		if( in.bad( ) ) {
+			return std::nullopt;
+		}
+		return result;
+	}
+
+	void schema_cache_t::store( std::uint64_t key,
+	                            char const *extension,
+	                            std::string_view data ) const {
+		auto ec = std::error_code( );
+		std::filesystem::create_directories( m_directory, ec );
+		if( ec ) {
+			return;
+		}
+		// Write to a file of our own then rename it, so that a concurrent run
+		// never reads a partial entry.  The thread id only tells the threads of
+		// this process apart, the random part those of other processes
+		auto const path = entry_path( key, extension );
+		auto tmp_path = path;
+		tmp_path += fmt::format( ".{:x}.{:x}.tmp",
+		                         std::hash<std::thread::id>{ }( std::this_thread::get_id( ) ),
+		                         std::random_device{ }( ) );
+		{
+			auto out = std::ofstream( tmp_path, std::ios::binary | std::ios::trunc );
+			out.write( data.data( ), static_cast<std::streamsize>( data.size( ) ) );
+			if( not out ) {
+				out.close( );
+				std::filesystem::remove( tmp_path, ec );
+				return;
+			}
+		}
+		std::filesystem::rename( tmp_path, path, ec );
+		if( ec ) {
+			std::filesystem::remove( tmp_path, ec );
+		}
+	}
+
+	std::optional<schema_t> schema_cache_t::load_schema( std::uint64_t key ) const {
+		if( auto data = load( key, ".schema" ) ) {
+			return deserialize_schema( *data );
+		}
+		return std::nullopt;
+	}
+
+	void schema_cache_t::store_schema( std::uint64_t key, schema_t const &schema ) const {
+		store( key, ".schema", serialize_schema( schema ) );
+	}
+
+	std::optional<std::string> schema_cache_t::load_output( std::uint64_t key ) const {
+		return load( key, ".out" );
+	}
+
+	void schema_cache_t::store_output( std::uint64_t key, std::string_view output ) const {
+		store( key, ".out", output );
+	}
+} // namespace daw::json_to_cpp
@@ -0,0 +1,648 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <daw/daw_visit.h>
+
+#include "mapped_file.h"
+#include "schema_snapshot.h"
+#include "types/ti_arena.h"
+#include "types/ti_types.h"
+
+// Layout, all integers are little endian
+//   magic "J2CS", u32 schema_format_version, u8 state_t flags
+//   u32 string count, then per string u32 size and the bytes
+//   u32 object count, then per object u32 name, u32 first member, u32 member
+//     count, u64 instances and per member u64 instances that had it
+//   u32 node count, then per node u8 type index, u8 flags, u32 name for
+//     objects and kv's, u32 first member and u32 member count for arrays and
+//     kv's, u64 min and max length, u64 instances, u32 fixed size max and u32
+//     small size max for arrays, i64 min, u64 max and u8 margin bits for integrals, u32 enum
+//     name, u64 value count, u32 max values, u32 value count and per value
+//     u32 string for strings with tracked values
+//   u32 member count, then per member u32 key, u32 node
+// A node is one ti_types_t.  Objects refer to the registry entry of their
+// name, arrays and kv's have a range of members with the element types or
+// no_members if they have none.
+namespace daw::json_to_cpp {
+	namespace {
+		constexpr char schema_magic[4] = { 'J', '2', 'C', 'S' };
+		constexpr std::uint32_t no_members = 0xFFFF'FFFFU;
+
+		// state_t flags
+		constexpr unsigned has_arrays_flag = 1U;
+		constexpr unsigned has_integrals_flag = 2U;
+		constexpr unsigned has_optionals_flag = 4U;
+		constexpr unsigned has_strings_flag = 8U;
+		constexpr unsigned has_kv_flag = 16U;
+		// Node flags
+		constexpr unsigned optional_flag = 1U;
+		constexpr unsigned string_view_flag = 2U;
+		constexpr unsigned float_flag = 4U;
+		constexpr unsigned string_values_flag = 8U;
+		constexpr unsigned values_overflow_flag = 16U;
+
+		struct member_range_t {
+			std::uint32_t first = no_members;
+			std::uint32_t count = 0;
+		};
+
+		struct object_entry_t {
+			std::uint32_t name = 0;
+			member_range_t members{ };
+			std::uint64_t instances = 0;
+			std::vector<std::uint64_t> present{ };
+		};
+
+		struct node_entry_t {
+			std::uint8_t tag = 0;
+			std::uint8_t flags = 0;
+			std::uint32_t name = 0;
+			member_range_t members{ };
+			types::ti_integral range{ };
+			// Arrays, only the lengths are used
+			types::ti_array sizes{ };
+			// Strings with tracked values
+			std::uint32_t enum_stem = 0;
+			std::uint64_t value_count = 0;
+			std::uint32_t max_values = 0;
+			std::vector<std::uint32_t> values{ };
+		};
+
+		struct member_entry_t {
+			std::uint32_t key = 0;
+			std::uint32_t node = 0;
+		};
+
+		constexpr bool has_name( std::uint8_t tag ) noexcept {
+			return tag == types::impl::ti_object_pos or tag == types::impl::ti_kv_pos;
+		}
+
+		constexpr bool has_members( std::uint8_t tag ) noexcept {
+			return tag == types::impl::ti_array_pos or tag == types::impl::ti_kv_pos;
+		}
+
+		constexpr bool has_range( std::uint8_t tag ) noexcept {
+			return tag == types::impl::ti_integral_pos;
+		}
+
+		bool is_optional( types::ti_types_t const &value ) {
+			return daw::visit_nt( value, []( auto const &item ) { return item.is_optional; } );
+		}
+
+		void set_optional( types::ti_types_t &value, bool is_opt ) {
+			daw::visit_nt( value, [is_opt]( auto &item ) { item.is_optional = is_opt; } );
+		}
+
+		/// Flattens a schema into the string, object, node and member tables
+		class schema_writer {
+			std::vector<std::string_view> m_strings{ };
+			std::unordered_map<std::string_view, std::uint32_t> m_string_index{ };
+			std::vector<object_entry_t> m_objects{ };
+			std::vector<node_entry_t> m_nodes{ };
+			std::vector<member_entry_t> m_members{ };
+			std::string m_out{ };
+
+			void put_u8( std::uint8_t value ) {
+				m_out.push_back( static_cast<char>( value ) );
+			}
+
+			void put_u32( std::uint32_t value ) {
+				for( int n = 0; n < 4; ++n ) {
+					m_out.push_back( static_cast<char>( ( value >> ( 8 * n ) ) & 0xFFU ) );
+				}
+			}
+
+			void put_u64( std::uint64_t value ) {
+				for( int n = 0; n < 8; ++n ) {
+					m_out.push_back( static_cast<char>( ( value >> ( 8 * n ) ) & 0xFFU ) );
+				}
+			}
+
+			void put_size( std::size_t value ) {
+				put_u32( static_cast<std::uint32_t>( value ) );
+			}
+
+			std::uint32_t add_string( std::string_view str ) {
+				auto const pos =
+				  m_string_index.try_emplace( str, static_cast<std::uint32_t>( m_strings.size( ) ) ).first;
+				if( pos->second == m_strings.size( ) ) {
+					m_strings.push_back( str );
+				}
+				return pos->second;
+			}
+
+			// The members of one map are contiguous, so their range is reserved
+			// before the nodes of the member types are added
+			member_range_t add_members( types::ti_object::child_t const &children ) {
+				auto const first = m_members.size( );
+				m_members.resize( first + children.size( ) );
+				auto idx = first;
+				for( auto const &child : children ) {
+					auto const key = add_string( child.first );
+					auto const node = add_node( child.second );
+					m_members[idx++] = member_entry_t{ key, node };
+				}
+				return { static_cast<std::uint32_t>( first ), static_cast<std::uint32_t>( children.size( ) ) };
+			}
+
+			member_range_t add_optional_members( types::ti_object::child_t const *children ) {
+				if( children == nullptr ) {
+					return { };
+				}
+				return add_members( *children );
+			}
+
+			std::uint32_t add_node( types::ti_types_t const &value ) {
+				using namespace daw::json_to_cpp::types;
+				auto const idx = m_nodes.size( );
+				auto node = node_entry_t{ };
+				node.tag = static_cast<std::uint8_t>( value.index( ) );
+				unsigned flags = is_optional( value ) ? optional_flag : 0U;
+				if( auto const *str = std::get_if<ti_string>( &value );
+				    str != nullptr and str->use_string_view( ) ) {
+					flags |= string_view_flag;
+				}
+				if( auto const *real = std::get_if<ti_real>( &value ); real != nullptr and real->is_float ) {
+					flags |= float_flag;
+				}
+				if( auto const *integral = std::get_if<ti_integral>( &value ) ) {
+					node.range = *integral;
+				}
+				if( auto const *arry = std::get_if<ti_array>( &value ) ) {
+					node.sizes = *arry;
+				}
+				if( auto const *str = std::get_if<ti_string>( &value ); str != nullptr and str->values != nullptr ) {
+					auto const &values = *str->values;
+					flags |= string_values_flag;
+					if( values.is_overflow ) {
+						flags |= values_overflow_flag;
+					}
+					node.enum_stem = add_string( str->enum_stem );
+					node.value_count = values.count;
+					node.max_values = static_cast<std::uint32_t>( values.max_values );
+					for( auto const &v : values.values ) {
+						node.values.push_back( add_string( v ) );
+					}
+				}
+				node.flags = static_cast<std::uint8_t>( flags );
+				m_nodes.push_back( node );
+				daw::visit_nt(
+				  value,
+				  [&]( ti_object const &obj ) { m_nodes[idx].name = add_string( obj.object_name ); },
+				  [&]( ti_array const &arry ) {
+					  auto const members = add_optional_members( arry.children );
+					  m_nodes[idx].members = members;
+				  },
+				  [&]( ti_kv const &kv ) {
+					  m_nodes[idx].name = add_string( kv.kv_name );
+					  auto const members = add_optional_members( kv.value );
+					  m_nodes[idx].members = members;
+				  },
+				  []( auto const & ) {} );
+				return static_cast<std::uint32_t>( idx );
+			}
+
+			void put_range( member_range_t range ) {
+				put_u32( range.first );
+				put_u32( range.count );
+			}
+
+		public:
+			std::string write( schema_t const &schema ) {
+				// Every object is named before any member refers to one
+				for( auto const &obj : schema.obj_info ) {
+					m_objects.push_back( object_entry_t{ add_string( obj.object_name ), { } } );
+				}
+				for( std::size_t n = 0; n < schema.obj_info.size( ); ++n ) {
+					auto const &obj = schema.obj_info[n];
+					auto const members = add_members( *obj.children );
+					auto &entry = m_objects[n];
+					entry.members = members;
+					// Unknown counts are stored as no instances
+					entry.present.resize( members.count, 0U );
+					if( obj.counts != nullptr ) {
+						entry.instances = obj.counts->instances;
+						for( std::size_t m = 0; m < members.count; ++m ) {
+							entry.present[m] = obj.counts->present_count( m );
+						}
+					}
+				}
+
+				m_out.append( schema_magic, sizeof( schema_magic ) );
+				put_u32( schema_format_version );
+				auto const &state = schema.state;
+				put_u8( static_cast<std::uint8_t>(
+				  ( state.has_arrays ? has_arrays_flag : 0U ) | ( state.has_integrals ? has_integrals_flag : 0U ) |
+				  ( state.has_optionals ? has_optionals_flag : 0U ) |
+				  ( state.has_strings ? has_strings_flag : 0U ) | ( state.has_kv ? has_kv_flag : 0U ) ) );
+				put_size( m_strings.size( ) );
+				for( auto str : m_strings ) {
+					put_size( str.size( ) );
+					m_out.append( str.data( ), str.size( ) );
+				}
+				put_size( m_objects.size( ) );
+				for( auto const &obj : m_objects ) {
+					put_u32( obj.name );
+					put_range( obj.members );
+					put_u64( obj.instances );
+					for( auto count : obj.present ) {
+						put_u64( count );
+					}
+				}
+				put_size( m_nodes.size( ) );
+				for( auto const &node : m_nodes ) {
+					put_u8( node.tag );
+					put_u8( node.flags );
+					if( has_name( node.tag ) ) {
+						put_u32( node.name );
+					}
+					if( has_members( node.tag ) ) {
+						put_range( node.members );
+					}
+					if( node.tag == types::impl::ti_array_pos ) {
+						put_u64( node.sizes.min_size );
+						put_u64( node.sizes.max_size );
+						put_u64( node.sizes.instances );
+						put_u32( node.sizes.fixed_size_max );
+						put_u32( node.sizes.small_size_max );
+					}
+					if( has_range( node.tag ) ) {
+						put_u64( static_cast<std::uint64_t>( node.range.min_value ) );
+						put_u64( node.range.max_value );
+						put_u8( node.range.margin_bits );
+					}
+					if( ( node.flags & string_values_flag ) != 0 ) {
+						put_u32( node.enum_stem );
+						put_u64( node.value_count );
+						put_u32( node.max_values );
+						put_size( node.values.size( ) );
+						for( auto v : node.values ) {
+							put_u32( v );
+						}
+					}
+				}
+				put_size( m_members.size( ) );
+				for( auto const &member : m_members ) {
+					put_u32( member.key );
+					put_u32( member.node );
+				}
+				return std::move( m_out );
+			}
+		};
+
+		/// Reads what schema_writer wrote.  Reading past the end or an out of
+		/// range index marks the data as bad instead of throwing
+		class schema_reader {
+			std::string_view m_data;
+			bool m_ok = true;
+			std::vector<std::string_view> m_strings{ };
+			std::vector<object_entry_t> m_objects{ };
+			std::vector<node_entry_t> m_nodes{ };
+			std::vector<member_entry_t> m_members{ };
+
+			std::uint8_t get_u8( ) {
+				if( m_data.empty( ) ) {
+					m_ok = false;
+					return 0;
+				}
+				auto const result = static_cast<std::uint8_t>( m_data.front( ) );
+				m_data.remove_prefix( 1 );
+				return result;
+			}
+
+			std::uint32_t get_u32( ) {
+				if( m_data.size( ) < 4 ) {
+					m_ok = false;
+					m_data = { };
+					return 0;
+				}
+				std::uint32_t result = 0;
+				for( int n = 0; n < 4; ++n ) {
+					result |= static_cast<std::uint32_t>( static_cast<std::uint8_t>( m_data[n] ) ) << ( 8 * n );
+				}
+				m_data.remove_prefix( 4 );
+				return result;
+			}
+
+			std::uint64_t get_u64( ) {
+				auto const low = get_u32( );
+				return static_cast<std::uint64_t>( get_u32( ) ) << 32U | low;
+			}
+
+			// A count of entries of at least min_size bytes each, that cannot be
+			// larger than the remaining data
+			std::uint32_t get_count( std::size_t min_size ) {
+				auto const count = get_u32( );
+				if( count > m_data.size( ) / min_size ) {
+					m_ok = false;
+					return 0;
+				}
+				return count;
+			}
+
+			member_range_t get_range( ) {
+				auto const first = get_u32( );
+				auto const count = get_u32( );
+				return { first, count };
+			}
+
+			bool valid_string( std::uint32_t idx ) const noexcept {
+				return idx < m_strings.size( );
+			}
+
+			bool valid_range( member_range_t range ) const noexcept {
+				return range.first <= m_members.size( ) and range.count <= m_members.size( ) - range.first;
+			}
+
+			void read_tables( ) {
+				auto const string_count = get_count( 4 );
+				m_strings.reserve( string_count );
+				for( std::uint32_t n = 0; m_ok and n < string_count; ++n ) {
+					auto const size = get_u32( );
+					if( size > m_data.size( ) ) {
+						m_ok = false;
+						return;
+					}
+					m_strings.push_back( m_data.substr( 0, size ) );
+					m_data.remove_prefix( size );
+				}
+				auto const object_count = get_count( 20 );
+				m_objects.reserve( object_count );
+				for( std::uint32_t n = 0; m_ok and n < object_count; ++n ) {
+					auto obj = object_entry_t{ };
+					obj.name = get_u32( );
+					obj.members = get_range( );
+					obj.instances = get_u64( );
+					if( obj.members.count > m_data.size( ) / 8U ) {
+						m_ok = false;
+						return;
+					}
+					obj.present.resize( obj.members.count );
+					for( auto &count : obj.present ) {
+						count = get_u64( );
+					}
+					m_objects.push_back( std::move( obj ) );
+				}
+				auto const node_count = get_count( 2 );
+				m_nodes.reserve( node_count );
+				for( std::uint32_t n = 0; m_ok and n < node_count; ++n ) {
+					auto node = node_entry_t{ };
+					node.tag = get_u8( );
+					node.flags = get_u8( );
+					if( has_name( node.tag ) ) {
+						node.name = get_u32( );
+					}
+					if( has_members( node.tag ) ) {
+						node.members = get_range( );
+					}
+					if( node.tag == types::impl::ti_array_pos ) {
+						node.sizes.min_size = get_u64( );
+						node.sizes.max_size = get_u64( );
+						node.sizes.instances = get_u64( );
+						node.sizes.fixed_size_max = get_u32( );
+						node.sizes.small_size_max = get_u32( );
+					}
+					if( has_range( node.tag ) ) {
+						node.range.min_value = static_cast<std::int64_t>( get_u64( ) );
+						node.range.max_value = get_u64( );
+						node.range.margin_bits = get_u8( );
+					}
+					if( node.tag == types::impl::ti_string_pos and ( node.flags & string_values_flag ) != 0 ) {
+						node.enum_stem = get_u32( );
+						node.value_count = get_u64( );
+						node.max_values = get_u32( );
+						auto const value_count = get_count( 4 );
+						node.values.reserve( value_count );
+						for( std::uint32_t v = 0; m_ok and v < value_count; ++v ) {
+							node.values.push_back( get_u32( ) );
+						}
+					}
+					m_nodes.push_back( std::move( node ) );
+				}
+				auto const member_count = get_count( 8 );
+				m_members.reserve( member_count );
+				for( std::uint32_t n = 0; m_ok and n < member_count; ++n ) {
+					auto const key = get_u32( );
+					m_members.push_back( member_entry_t{ key, get_u32( ) } );
+				}
+				m_ok = m_ok and m_data.empty( );
+			}
+
+			/// Copy the member types in range into children.  The member nodes
+			/// must be after first_node, which rules out cycles
+			bool fill_members( types::ti_object::child_t &children,
+			                   member_range_t range,
+			                   std::size_t first_node,
+			                   std::vector<types::ti_types_t> const &values ) const {
+				if( not valid_range( range ) ) {
+					return false;
+				}
+				for( auto n = range.first; n < range.first + range.count; ++n ) {
+					auto const &member = m_members[n];
+					if( not valid_string( member.key ) or member.node < first_node or
+					    member.node >= values.size( ) ) {
+						return false;
+					}
+					children[m_strings[member.key]] = values[member.node];
+				}
+				return true;
+			}
+
+			/// The elements of an array or the values of a kv.  They always get a
+			/// map, as merging and code generation expect one, and no_members is
+			/// read as an empty map
+			types::ti_object::child_t *make_members( member_range_t range,
+			                                         std::size_t node,
+			                                         std::vector<types::ti_types_t> const &values,
+			                                         types::ti_arena &arena ) {
+				auto *result = arena.make_children( );
+				if( range.first == no_members ) {
+					return result;
+				}
+				if( not fill_members( *result, range, node + 1U, values ) ) {
+					m_ok = false;
+				}
+				return result;
+			}
+
+		public:
+			explicit schema_reader( std::string_view data ) noexcept
+			  : m_data( data ) {}
+
+			std::optional<schema_t> read( ) {
+				using namespace daw::json_to_cpp::types;
+				if( m_data.size( ) < sizeof( schema_magic ) or
+				    std::memcmp( m_data.data( ), schema_magic, sizeof( schema_magic ) ) != 0 ) {
+					return std::nullopt;
+				}
+				m_data.remove_prefix( sizeof( schema_magic ) );
+				if( get_u32( ) != schema_format_version ) {
+					return std::nullopt;
+				}
+				auto const state_flags = get_u8( );
+				read_tables( );
+				if( not m_ok ) {
+					return std::nullopt;
+				}
+
+				auto result = schema_t( );
+				auto &arena = *result.arenas.emplace_back( std::make_unique<ti_arena>( ) );
+				for( auto &str : m_strings ) {
+					str = arena.intern( str );
+				}
+				result.state.has_arrays = ( state_flags & has_arrays_flag ) != 0;
+				result.state.has_integrals = ( state_flags & has_integrals_flag ) != 0;
+				result.state.has_optionals = ( state_flags & has_optionals_flag ) != 0;
+				result.state.has_strings = ( state_flags & has_strings_flag ) != 0;
+				result.state.has_kv = ( state_flags & has_kv_flag ) != 0;
+
+				for( auto const &obj : m_objects ) {
+					if( not valid_string( obj.name ) ) {
+						return std::nullopt;
+					}
+					auto const name = m_strings[obj.name];
+					result.obj_info.try_emplace( name, [&] {
+						auto value = ti_object( name, arena.make_children( ) );
+						value.counts = arena.make_member_counts( );
+						value.counts->instances = obj.instances;
+						value.counts->present.assign( obj.present.begin( ), obj.present.end( ) );
+						return value;
+					} );
+				}
+				if( result.obj_info.size( ) != m_objects.size( ) ) {
+					return std::nullopt;
+				}
+
+				// The elements of a node come after it, so building the nodes from
+				// last to first builds the elements first
+				auto values = std::vector<ti_types_t>( m_nodes.size( ) );
+				for( auto n = m_nodes.size( ); m_ok and n-- > 0; ) {
+					auto const &node = m_nodes[n];
+					auto &value = values[n];
+					switch( node.tag ) {
+					case impl::ti_null_pos:
+						break;
+					case impl::ti_array_pos: {
+						auto arry = node.sizes;
+						arry.children = make_members( node.members, n, values, arena );
+						value = arry;
+						break;
+					}
+					case impl::ti_boolean_pos:
+						value = ti_boolean( );
+						break;
+					case impl::ti_integral_pos:
+						value = node.range;
+						break;
+					case impl::ti_object_pos: {
+						auto const *obj =
+						  valid_string( node.name )
+						    ? result.obj_info.find(
+						        daw::string_view( m_strings[node.name].data( ), m_strings[node.name].size( ) ) )
+						    : nullptr;
+						if( obj == nullptr ) {
+							return std::nullopt;
+						}
+						value = ti_object( obj->object_name, obj->children );
+						break;
+					}
+					case impl::ti_real_pos:
+						value = ti_real( ( node.flags & float_flag ) != 0 );
+						break;
+					case impl::ti_string_pos: {
+						auto str = ti_string( ( node.flags & string_view_flag ) != 0 );
+						if( ( node.flags & string_values_flag ) != 0 ) {
+							if( not valid_string( node.enum_stem ) ) {
+								return std::nullopt;
+							}
+							str.enum_stem = m_strings[node.enum_stem];
+							str.values = arena.make_string_values( );
+							str.values->count = node.value_count;
+							str.values->max_values = node.max_values;
+							str.values->is_overflow = ( node.flags & values_overflow_flag ) != 0;
+							for( auto v : node.values ) {
+								if( not valid_string( v ) ) {
+									return std::nullopt;
+								}
+								str.values->values.push_back( m_strings[v] );
+							}
+						}
+						value = str;
+						break;
+					}
+					case impl::ti_kv_pos: {
+						if( not valid_string( node.name ) ) {
+							return std::nullopt;
+						}
+						value = ti_kv( m_strings[node.name], make_members( node.members, n, values, arena ) );
+						break;
+					}
+					default:
+						return std::nullopt;
+					}
+					set_optional( value, ( node.flags & optional_flag ) != 0 );
+				}
+				for( std::size_t n = 0; m_ok and n < m_objects.size( ); ++n ) {
+					m_ok = fill_members( *result.obj_info[n].children, m_objects[n].members, 0, values );
+				}
+				if( not m_ok ) {
+					return std::nullopt;
+				}
+				// Loading is not inference, start the statistics over
+				result.obj_info.reset_stats( );
+				return result;
+			}
+		};
+	} // namespace
+
+	std::string serialize_schema( schema_t const &schema ) {
+		return schema_writer( ).write( schema );
+	}
+
+	std::optional<schema_t> deserialize_schema( std::string_view data ) {
+		return schema_reader( data ).read( );
+	}
+
+	void save_schema_snapshot( std::filesystem::path const &path, schema_t const &schema ) {
+		auto const data = serialize_schema( schema );
+		auto out = std::ofstream( path, std::ios::out | std::ios::trunc | std::ios::binary );
+		out.write( data.data( ), static_cast<std::streamsize>( data.size( ) ) );
+		if( not out ) {
+			throw std::runtime_error( "Could not write schema snapshot '" + path.string( ) + "'" );
+		}
+	}
+
+	schema_t load_schema_snapshot( std::filesystem::path const &path ) {
+		auto const in_file = mapped_file_t( path );
+		if( not in_file ) {
+			throw std::runtime_error( "Could not open schema snapshot '" + path.string( ) + "'" );
+		}
+		auto const data = in_file.view( );
+		auto result = deserialize_schema( std::string_view( data.data( ), data.size( ) ) );
+		if( not result ) {
+			throw std::runtime_error( "'" + path.string( ) + "' is not a schema snapshot of format version " +
+			                          std::to_string( schema_format_version ) );
+		}
+		return std::move( *result );
+	}
+} // namespace daw::json_to_cpp
@@ -0,0 +1,35 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, version 1.0. (see accompanying
+// file license or copy at http://www.boost.org/license_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_json_link
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+
+#include "types/ti_arena.h"
+
+namespace daw::json_to_cpp::types {
+	namespace {
+		// Large enough for the types of most documents
+		constexpr std::size_t initial_arena_size = 64U * 1024U;
+	} // namespace
+
+	ti_arena::ti_arena( )
+	  : m_resource( initial_arena_size )
+	  , m_names( &m_resource ) {}
+
+	std::string_view ti_arena::intern( std::string_view name ) {
+		auto pos = m_names.find( name );
+		if( pos != m_names.end( ) ) {
+			return *pos;
+		}
+		auto *str = static_cast<char *>( m_resource.allocate( name.size( ) + 1U, 1U ) );
+		std::copy( name.begin( ), name.end( ), str );
+		str[name.size( )] = '\0';
+		return *m_names.insert( std::string_view( str, name.size( ) ) ).first;
+	}
+} // namespace daw::json_to_cpp::types
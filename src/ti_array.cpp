@@ -7,6 +7,7 @@
 //
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include <daw/daw_visit.h>
@@ -44,45 +45,86 @@ namespace daw::json_to_cpp::types {
 	} // namespace
 
 	std::string ti_array::name( ) const {
-		if( children->empty( ) ) {
+		if( not children or children->empty( ) ) {
 			return "std::vector<" + ti_null::name( ) + ">";
 		}
-		return "std::vector<" +
-		       daw::json_to_cpp::types::name( children->front( ).second ) + ">";
+		auto const element = daw::json_to_cpp::types::name( children->front( ).second );
+		if( is_fixed_size( ) ) {
+			return "std::array<" + element + ", " + std::to_string( max_size ) + ">";
+		}
+		if( is_small_vector( ) ) {
+			return "boost::container::small_vector<" + element + ", " + std::to_string( max_size ) + ">";
+		}
+		return "std::vector<" + element + ">";
+	}
+
+	bool ti_array::add_size( std::uint64_t length ) noexcept {
+		++instances;
+		return widen_sizes( length, length );
+	}
+
+	bool ti_array::widen_sizes( std::uint64_t min_length, std::uint64_t max_length ) noexcept {
+		bool changed = false;
+		if( min_length < min_size ) {
+			min_size = min_length;
+			changed = true;
+		}
+		if( max_length > max_size ) {
+			max_size = max_length;
+			changed = true;
+		}
+		return changed;
+	}
+
+	bool ti_array::merge_sizes( ti_array const &other ) noexcept {
+		instances += other.instances;
+		if( other.min_size > other.max_size ) {
+			return false;
+		}
+		return widen_sizes( other.min_size, other.max_size );
+	}
+
+	bool ti_array::is_fixed_size( ) const noexcept {
+		return instances > 1 and min_size == max_size and max_size > 0 and max_size <= fixed_size_max and
+		       children and not children->empty( );
+	}
+
+	bool ti_array::is_small_vector( ) const noexcept {
+		return instances > 1 and min_size <= max_size and max_size > 0 and max_size <= small_size_max and
+		       children and not children->empty( );
 	}
 
 	std::string ti_array::json_name( daw::string_view member_name, bool use_cpp20,
 	                                 daw::string_view parent_name ) const {
-		if( children->empty( ) ) {
+		if( not children or children->empty( ) ) {
 			return "json_array<" +
 			       impl::format_member_name( member_name, use_cpp20, parent_name ) +
 			       ", " + ti_null::array_member_info( ) + ", " + name( ) + ">";
 		}
-		return "json_array<" +
-		       impl::format_member_name( member_name, use_cpp20, parent_name ) +
-		       ", " +
-		       daw::json_to_cpp::types::array_member_info(
-		         children->front( ).second ) +
-		       ", " + name( ) + ">";
+		auto result = "json_array<" +
+		              impl::format_member_name( member_name, use_cpp20, parent_name ) +
+		              ", " +
+		              daw::json_to_cpp::types::array_member_info(
+		                children->front( ).second ) +
+		              ", " + name( );
+		if( is_fixed_size( ) ) {
+			// std::array cannot be constructed from the range of elements
+			result += ", fixed_array_constructor_t<" +
+			          daw::json_to_cpp::types::name( children->front( ).second ) + ", " +
+			          std::to_string( max_size ) + ">";
+		}
+		return result + ">";
 	}
 
 	std::string ti_array::array_member_info( ) const {
 		return json_name( "no_name", false, "" );
 	}
 
-	ti_array::ti_array( )
-	  : children( std::make_unique<child_t>( ) ) {}
-
-	ti_array::ti_array( const ti_array &other )
-	  : children( std::make_unique<child_t>( *other.children ) )
-	  , is_optional( other.is_optional ) {}
+	ti_array::ti_array( child_t *elements ) noexcept
+	  : children( elements ) {}
 
-	ti_array &ti_array::operator=( ti_array const &rhs ) {
-		if( this != &rhs ) {
-			*children = *rhs.children;
-			is_optional = rhs.is_optional;
-		}
-		return *this;
-	}
+	ti_array::ti_array( std::uint32_t fixed_max, std::uint32_t small_max ) noexcept
+	  : fixed_size_max( fixed_max )
+	  , small_size_max( small_max ) {}
 
 } // namespace daw::json_to_cpp::types
@@ -14,26 +14,12 @@
 #include <daw/daw_visit.h>
 
 namespace daw::json_to_cpp::types {
-	ti_kv::ti_kv( std::string obj_name )
-	  : value( std::make_unique<child_t>( ) )
+	ti_kv::ti_kv( std::string_view obj_name, child_t *values ) noexcept
+	  : value( values )
 	  , kv_name( obj_name ) {}
 
-	ti_kv::ti_kv( ti_kv const &other )
-	  : is_optional( other.is_optional )
-	  , value( std::make_unique<child_t>( *other.value ) )
-	  , kv_name( other.kv_name ) {}
-
-	ti_kv &ti_kv::operator=( ti_kv const &rhs ) {
-		if( this != &rhs ) {
-			is_optional = rhs.is_optional;
-			*value = *rhs.value;
-			kv_name = rhs.kv_name;
-		}
-		return *this;
-	}
-
 	std::string ti_kv::name( ) const {
-		if( !value ) {
+		if( not value or value->empty( ) ) {
 			return "std::unordered_map<std::string, " + ti_null::name( ) + ">";
 		}
 		return "std::unordered_map<std::string, " +
@@ -54,7 +40,7 @@ namespace daw::json_to_cpp::types {
 		  "json_key_value<" +
 		  impl::format_member_name( member_name, use_cpp20, parent_name ) + ", " +
 		  name( ) + ", ";
-		if( value ) {
+		if( value and not value->empty( ) ) {
 			result += daw::visit_nt(
 			  value->front( ).second,
 			  []( auto const &item ) -> std::string {
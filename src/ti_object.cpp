@@ -18,12 +18,12 @@
 namespace daw::json_to_cpp::types {
 
 	std::string ti_object::name( ) const {
-		return object_name;
+		return std::string( object_name );
 	}
 
-	ti_object::ti_object( std::string obj_name )
-	  : children( std::make_unique<child_t>( ) )
-	  , object_name( std::move( obj_name ) ) {}
+	ti_object::ti_object( std::string_view obj_name, child_t *members ) noexcept
+	  : children( members )
+	  , object_name( obj_name ) {}
 
 	std::string ti_object::json_name( daw::string_view member_name,
 	                                  bool use_cpp20,
@@ -44,18 +44,4 @@ namespace daw::json_to_cpp::types {
 		return json_name( "no_name", false, "" );
 	}
 
-	ti_object::ti_object( ti_object const &other )
-	  : children( std::make_unique<child_t>( *other.children ) )
-	  , is_optional( other.is_optional )
-	  , object_name( other.object_name ) {}
-
-	ti_object &ti_object::operator=( ti_object const &rhs ) {
-		if( this != &rhs ) {
-			*children = *rhs.children;
-			is_optional = rhs.is_optional;
-			object_name = rhs.object_name;
-		}
-		return *this;
-	}
-
 } // namespace daw::json_to_cpp::types
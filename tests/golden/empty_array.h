@@ -0,0 +1,27 @@
+#pragma once
+
+#include <tuple>
+#include <cstdint>
+#include <vector>
+#include <daw/json/daw_json_link.h>
+
+struct root_object_t {
+	int64_t id;
+	std::vector<void*> empty;
+};	// root_object_t
+
+namespace daw::json {
+	template<>
+	struct json_data_contract<root_object_t> {
+		static constexpr char const mem_id[] = "id";
+		static constexpr char const mem_empty[] = "empty";
+		 using type = json_member_list<
+				json_number<mem_id, int64_t>
+				,json_array<mem_empty, json_custom<no_name>, std::vector<void*>>
+	>;
+
+		static inline auto to_json_data( root_object_t const & value ) {
+			return std::forward_as_tuple( value.id, value.empty );
+}
+	};
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <tuple>
+#include <optional>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <daw/json/daw_json_link.h>
+
+enum class a_b_c_t : std::uint8_t {
+	on
+};	// a_b_c_t
+
+struct a_b_c_converter_t {
+	a_b_c_t operator( )( std::string_view value ) const {
+		if( value == "on" ) {
+			return a_b_c_t::on;
+		}
+		throw std::invalid_argument( "Unknown a_b_c_t value" );
+	}
+
+	std::string_view operator( )( a_b_c_t value ) const {
+		switch( value ) {
+		case a_b_c_t::on:
+			return "on";
+		}
+		return { };
+	}
+};	// a_b_c_converter_t
+
+enum class a_b_c_2_t : std::uint8_t {
+	off
+};	// a_b_c_2_t
+
+struct a_b_c_2_converter_t {
+	a_b_c_2_t operator( )( std::string_view value ) const {
+		if( value == "off" ) {
+			return a_b_c_2_t::off;
+		}
+		throw std::invalid_argument( "Unknown a_b_c_2_t value" );
+	}
+
+	std::string_view operator( )( a_b_c_2_t value ) const {
+		switch( value ) {
+		case a_b_c_2_t::off:
+			return "off";
+		}
+		return { };
+	}
+};	// a_b_c_2_converter_t
+
+enum class rows_element_status_2_t : std::uint8_t {
+	open,
+	closed
+};	// rows_element_status_2_t
+
+struct rows_element_status_2_converter_t {
+	rows_element_status_2_t operator( )( std::string_view value ) const {
+		if( value == "open" ) {
+			return rows_element_status_2_t::open;
+		}
+		if( value == "closed" ) {
+			return rows_element_status_2_t::closed;
+		}
+		throw std::invalid_argument( "Unknown rows_element_status_2_t value" );
+	}
+
+	std::string_view operator( )( rows_element_status_2_t value ) const {
+		switch( value ) {
+		case rows_element_status_2_t::open:
+			return "open";
+		case rows_element_status_2_t::closed:
+			return "closed";
+		}
+		return { };
+	}
+};	// rows_element_status_2_converter_t
+
+struct a_t {
+	a_b_c_t b_c;
+};	// a_t
+
+struct a_b_t {
+	a_b_c_2_t c;
+};	// a_b_t
+
+struct rows_element_t {
+	rows_element_status_2_t status;
+	std::optional<a_t> a;
+	std::optional<a_b_t> a_b;
+};	// rows_element_t
+
+struct rows_element_status_t {
+	int64_t code;
+};	// rows_element_status_t
+
+struct root_object_t {
+	std::vector<rows_element_t> rows;
+	rows_element_status_t rows_element_status;
+};	// root_object_t
+
+namespace daw::json {
+	template<>
+	struct json_data_contract<a_t> {
+		static constexpr char const mem_b_c[] = "b_c";
+		 using type = json_member_list<
+				json_custom<mem_b_c, a_b_c_t, a_b_c_converter_t, a_b_c_converter_t>
+	>;
+
+		static inline auto to_json_data( a_t const & value ) {
+			return std::forward_as_tuple( value.b_c );
+}
+	};
+}
+namespace daw::json {
+	template<>
+	struct json_data_contract<a_b_t> {
+		static constexpr char const mem_c[] = "c";
+		 using type = json_member_list<
+				json_custom<mem_c, a_b_c_2_t, a_b_c_2_converter_t, a_b_c_2_converter_t>
+	>;
+
+		static inline auto to_json_data( a_b_t const & value ) {
+			return std::forward_as_tuple( value.c );
+}
+	};
+}
+namespace daw::json {
+	template<>
+	struct json_data_contract<rows_element_t> {
+		static constexpr char const mem_status[] = "status";
+		static constexpr char const mem_a[] = "a";
+		static constexpr char const mem_a_b[] = "a_b";
+		 using type = json_member_list<
+				json_custom<mem_status, rows_element_status_2_t, rows_element_status_2_converter_t, rows_element_status_2_converter_t>
+				,json_nullable<json_class<mem_a, a_t>>
+				,json_nullable<json_class<mem_a_b, a_b_t>>
+	>;
+
+		static inline auto to_json_data( rows_element_t const & value ) {
+			return std::forward_as_tuple( value.status, value.a, value.a_b );
+}
+	};
+}
+namespace daw::json {
+	template<>
+	struct json_data_contract<rows_element_status_t> {
+		static constexpr char const mem_code[] = "code";
+		 using type = json_member_list<
+				json_number<mem_code, int64_t>
+	>;
+
+		static inline auto to_json_data( rows_element_status_t const & value ) {
+			return std::forward_as_tuple( value.code );
+}
+	};
+}
+namespace daw::json {
+	template<>
+	struct json_data_contract<root_object_t> {
+		static constexpr char const mem_rows[] = "rows";
+		static constexpr char const mem_rows_element_status[] = "rows_element_status";
+		 using type = json_member_list<
+				json_array<mem_rows, json_class_no_name<rows_element_t>, std::vector<rows_element_t>>
+				,json_class<mem_rows_element_status, rows_element_status_t>
+	>;
+
+		static inline auto to_json_data( root_object_t const & value ) {
+			return std::forward_as_tuple( value.rows, value.rows_element_status );
+}
+	};
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <tuple>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <daw/json/daw_json_link.h>
+
+struct root_object_element_t {
+	std::string a;
+};	// root_object_element_t
+
+struct root_object_t {
+	std::vector<root_object_element_t> root_object;
+};	// root_object_t
+
+namespace daw::json {
+	template<>
+	struct json_data_contract<root_object_element_t> {
+		static constexpr char const mem_a[] = "a";
+		 using type = json_member_list<
+				json_string<mem_a>
+	>;
+
+		static inline auto to_json_data( root_object_element_t const & value ) {
+			return std::forward_as_tuple( value.a );
+}
+	};
+}
+namespace daw::json {
+	template<>
+	struct json_data_contract<root_object_t> {
+		static constexpr char const mem_root_object[] = "root_object";
+		 using type = json_member_list<
+				json_array<mem_root_object, json_class_no_name<root_object_element_t>, std::vector<root_object_element_t>>
+	>;
+
+		static inline auto to_json_data( root_object_t const & value ) {
+			return std::forward_as_tuple( value.root_object );
+}
+	};
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <tuple>
+#include <optional>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <daw/json/daw_json_link.h>
+
+struct root_object_t {
+	int64_t id;
+	std::optional<std::string> name;
+	std::optional<std::vector<int64_t>> values;
+	std::optional<double> score;
+};	// root_object_t
+
+namespace daw::json {
+	template<>
+	struct json_data_contract<root_object_t> {
+		static constexpr char const mem_id[] = "id";
+		static constexpr char const mem_name[] = "name";
+		static constexpr char const mem_values[] = "values";
+		static constexpr char const mem_score[] = "score";
+		 using type = json_member_list<
+				json_number<mem_id, int64_t>
+				,json_nullable<json_string<mem_name>>
+				,json_nullable<json_array<mem_values, int64_t, std::vector<int64_t>>>
+				,json_nullable<json_number<mem_score>>
+	>;
+
+		static inline auto to_json_data( root_object_t const & value ) {
+			return std::forward_as_tuple( value.id, value.name, value.values, value.score );
+}
+	};
+}
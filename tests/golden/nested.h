@@ -0,0 +1,116 @@
+#pragma once
+
+#include <tuple>
+#include <optional>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <daw/json/daw_json_link.h>
+
+struct dimensions_t {
+	double width;
+	int64_t height;
+	std::string unit;
+};	// dimensions_t
+
+struct supplier_t {
+	std::string code;
+};	// supplier_t
+
+struct parts_element_t {
+	int64_t part_id;
+	std::optional<std::string> label;
+	std::optional<double> weight;
+	std::optional<supplier_t> supplier;
+};	// parts_element_t
+
+struct root_object_t {
+	int64_t id;
+	std::string name;
+	double price;
+	bool in_stock;
+	dimensions_t dimensions;
+	std::vector<std::string> tags;
+	std::vector<std::vector<int64_t>> matrix;
+	std::vector<void*> empty;
+	std::vector<parts_element_t> parts;
+};	// root_object_t
+
+namespace daw::json {
+	template<>
+	struct json_data_contract<dimensions_t> {
+		static constexpr char const mem_width[] = "width";
+		static constexpr char const mem_height[] = "height";
+		static constexpr char const mem_unit[] = "unit";
+		 using type = json_member_list<
+				json_number<mem_width>
+				,json_number<mem_height, int64_t>
+				,json_string<mem_unit>
+	>;
+
+		static inline auto to_json_data( dimensions_t const & value ) {
+			return std::forward_as_tuple( value.width, value.height, value.unit );
+}
+	};
+}
+namespace daw::json {
+	template<>
+	struct json_data_contract<supplier_t> {
+		static constexpr char const mem_code[] = "code";
+		 using type = json_member_list<
+				json_string<mem_code>
+	>;
+
+		static inline auto to_json_data( supplier_t const & value ) {
+			return std::forward_as_tuple( value.code );
+}
+	};
+}
+namespace daw::json {
+	template<>
+	struct json_data_contract<parts_element_t> {
+		static constexpr char const mem_part_id[] = "part_id";
+		static constexpr char const mem_label[] = "label";
+		static constexpr char const mem_weight[] = "weight";
+		static constexpr char const mem_supplier[] = "supplier";
+		 using type = json_member_list<
+				json_number<mem_part_id, int64_t>
+				,json_nullable<json_string<mem_label>>
+				,json_nullable<json_number<mem_weight>>
+				,json_nullable<json_class<mem_supplier, supplier_t>>
+	>;
+
+		static inline auto to_json_data( parts_element_t const & value ) {
+			return std::forward_as_tuple( value.part_id, value.label, value.weight, value.supplier );
+}
+	};
+}
+namespace daw::json {
+	template<>
+	struct json_data_contract<root_object_t> {
+		static constexpr char const mem_id[] = "id";
+		static constexpr char const mem_name[] = "name";
+		static constexpr char const mem_price[] = "price";
+		static constexpr char const mem_in_stock[] = "in_stock";
+		static constexpr char const mem_dimensions[] = "dimensions";
+		static constexpr char const mem_tags[] = "tags";
+		static constexpr char const mem_matrix[] = "matrix";
+		static constexpr char const mem_empty[] = "empty";
+		static constexpr char const mem_parts[] = "parts";
+		 using type = json_member_list<
+				json_number<mem_id, int64_t>
+				,json_string<mem_name>
+				,json_number<mem_price>
+				,json_bool<mem_in_stock>
+				,json_class<mem_dimensions, dimensions_t>
+				,json_array<mem_tags, std::string, std::vector<std::string>>
+				,json_array<mem_matrix, json_array<no_name, int64_t, std::vector<int64_t>>, std::vector<std::vector<int64_t>>>
+				,json_array<mem_empty, json_custom<no_name>, std::vector<void*>>
+				,json_array<mem_parts, json_class_no_name<parts_element_t>, std::vector<parts_element_t>>
+	>;
+
+		static inline auto to_json_data( root_object_t const & value ) {
+			return std::forward_as_tuple( value.id, value.name, value.price, value.in_stock, value.dimensions, value.tags, value.matrix, value.empty, value.parts );
+}
+	};
+}
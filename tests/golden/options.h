@@ -0,0 +1,185 @@
+#pragma once
+
+#include <tuple>
+#include <optional>
+#include <memory>
+#include <utility>
+#include <cstdint>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/container/small_vector.hpp>
+#include <daw/json/daw_json_link.h>
+
+template<typename T, std::size_t N>
+struct fixed_array_constructor_t {
+	std::array<T, N> operator( )( ) const {
+		return { };
+	}
+
+	template<typename Iterator>
+	std::array<T, N> operator( )( Iterator first, Iterator last ) const {
+		auto result = std::array<T, N>{ };
+		std::size_t n = 0;
+		for( ; first != last and n < N; ++first ) {
+			result[n++] = *first;
+		}
+		if( n != N or first != last ) {
+			throw std::invalid_argument( "Expected an array of " + std::to_string( N ) + " elements" );
+		}
+		return result;
+	}
+};	// fixed_array_constructor_t
+
+enum class rows_element_status_t : std::uint8_t {
+	open,
+	closed,
+	on_hold
+};	// rows_element_status_t
+
+struct rows_element_status_converter_t {
+	rows_element_status_t operator( )( std::string_view value ) const {
+		if( value == "open" ) {
+			return rows_element_status_t::open;
+		}
+		if( value == "closed" ) {
+			return rows_element_status_t::closed;
+		}
+		if( value == "on-hold" ) {
+			return rows_element_status_t::on_hold;
+		}
+		throw std::invalid_argument( "Unknown rows_element_status_t value" );
+	}
+
+	std::string_view operator( )( rows_element_status_t value ) const {
+		switch( value ) {
+		case rows_element_status_t::open:
+			return "open";
+		case rows_element_status_t::closed:
+			return "closed";
+		case rows_element_status_t::on_hold:
+			return "on-hold";
+		}
+		return { };
+	}
+};	// rows_element_status_converter_t
+
+enum class rows_element_tags_element_t : std::uint8_t {
+	t
+};	// rows_element_tags_element_t
+
+struct rows_element_tags_element_converter_t {
+	rows_element_tags_element_t operator( )( std::string_view value ) const {
+		if( value == "t" ) {
+			return rows_element_tags_element_t::t;
+		}
+		throw std::invalid_argument( "Unknown rows_element_tags_element_t value" );
+	}
+
+	std::string_view operator( )( rows_element_tags_element_t value ) const {
+		switch( value ) {
+		case rows_element_tags_element_t::t:
+			return "t";
+		}
+		return { };
+	}
+};	// rows_element_tags_element_converter_t
+
+struct rows_element_cold_t {
+	std::optional<std::string> note;
+};	// rows_element_cold_t
+
+struct rows_element_t {
+	std::array<uint8_t, 3> pos;
+	boost::container::small_vector<rows_element_tags_element_t, 2> tags;
+	float score;
+	uint8_t id;
+	rows_element_status_t status;
+	bool ok;
+	std::unique_ptr<rows_element_cold_t> cold;
+
+	rows_element_t( ) = default;
+	rows_element_t( std::array<uint8_t, 3> pos, boost::container::small_vector<rows_element_tags_element_t, 2> tags, float score, uint8_t id, rows_element_status_t status, bool ok, std::optional<std::string> note )
+	  : pos( std::move( pos ) )
+	  , tags( std::move( tags ) )
+	  , score( std::move( score ) )
+	  , id( std::move( id ) )
+	  , status( std::move( status ) )
+	  , ok( std::move( ok ) ) {
+		if( note ) {
+			cold = std::make_unique<rows_element_cold_t>( rows_element_cold_t{ std::move( note ) } );
+		}
+	}
+
+	rows_element_t( rows_element_t const & other )
+	  : pos( other.pos )
+	  , tags( other.tags )
+	  , score( other.score )
+	  , id( other.id )
+	  , status( other.status )
+	  , ok( other.ok )
+	  , cold( other.cold ? std::make_unique<rows_element_cold_t>( *other.cold ) : nullptr ) {}
+
+	rows_element_t( rows_element_t && ) = default;
+
+	rows_element_t & operator=( rows_element_t const & other ) {
+		*this = rows_element_t( other );
+		return *this;
+	}
+
+	rows_element_t & operator=( rows_element_t && ) = default;
+};	// rows_element_t
+
+struct root_object_t {
+	std::vector<rows_element_t> rows;
+	uint8_t count;
+};	// root_object_t
+
+namespace daw::json {
+	template<>
+	struct json_data_contract<rows_element_t> {
+		static constexpr char const mem_id[] = "id";
+		static constexpr char const mem_status[] = "status";
+		static constexpr char const mem_score[] = "score";
+		static constexpr char const mem_pos[] = "pos";
+		static constexpr char const mem_tags[] = "tags";
+		static constexpr char const mem_ok[] = "ok";
+		static constexpr char const mem_note[] = "note";
+		 using type = json_member_list<
+				json_array<mem_pos, uint8_t, std::array<uint8_t, 3>, fixed_array_constructor_t<uint8_t, 3>>
+				,json_array<mem_tags, json_custom_no_name<rows_element_tags_element_t, rows_element_tags_element_converter_t, rows_element_tags_element_converter_t>, boost::container::small_vector<rows_element_tags_element_t, 2>>
+				,json_number<mem_score, float>
+				,json_number<mem_id, uint8_t>
+				,json_custom<mem_status, rows_element_status_t, rows_element_status_converter_t, rows_element_status_converter_t>
+				,json_bool<mem_ok>
+				,json_nullable<json_string<mem_note>>
+	>;
+
+		static inline rows_element_cold_t const & cold_members( rows_element_t const & value ) {
+			static rows_element_cold_t const empty{ };
+			return value.cold ? *value.cold : empty;
+		}
+
+		static inline auto to_json_data( rows_element_t const & value ) {
+			return std::forward_as_tuple( value.pos, value.tags, value.score, value.id, value.status, value.ok, cold_members( value ).note );
+}
+	};
+}
+namespace daw::json {
+	template<>
+	struct json_data_contract<root_object_t> {
+		static constexpr char const mem_count[] = "count";
+		static constexpr char const mem_rows[] = "rows";
+		 using type = json_member_list<
+				json_array<mem_rows, json_class_no_name<rows_element_t>, std::vector<rows_element_t>>
+				,json_number<mem_count, uint8_t>
+	>;
+
+		static inline auto to_json_data( root_object_t const & value ) {
+			return std::forward_as_tuple( value.rows, value.count );
+}
+	};
+}
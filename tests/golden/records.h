@@ -0,0 +1,32 @@
+#pragma once
+
+#include <tuple>
+#include <optional>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <daw/json/daw_json_link.h>
+
+struct root_object_t {
+	int64_t a;
+	std::optional<std::string> b;
+	std::optional<std::vector<double>> c;
+};	// root_object_t
+
+namespace daw::json {
+	template<>
+	struct json_data_contract<root_object_t> {
+		static constexpr char const mem_a[] = "a";
+		static constexpr char const mem_b[] = "b";
+		static constexpr char const mem_c[] = "c";
+		 using type = json_member_list<
+				json_number<mem_a, int64_t>
+				,json_nullable<json_string<mem_b>>
+				,json_nullable<json_array<mem_c, double, std::vector<double>>>
+	>;
+
+		static inline auto to_json_data( root_object_t const & value ) {
+			return std::forward_as_tuple( value.a, value.b, value.c );
+}
+	};
+}
@@ -0,0 +1,110 @@
+# Copyright (c) Darrell Wright
+#
+# Distributed under the Boost Software License, Version 1.0. (See accompanying
+# file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+#
+# Official repository: https://github.com/beached/json_to_cpp
+#
+
+"""Runs json_to_cpp on urls served by a local http.server.
+
+Usage: http_test.py json_to_cpp fixtures golden work_dir
+"""
+
+import functools
+import http.server
+import json
+import os
+import shutil
+import subprocess
+import sys
+import threading
+
+
+def header_of(output):
+    """The header without the comment naming the inputs"""
+    start = output.find("#pragma once")
+    if start < 0:
+        raise AssertionError("json_to_cpp did not write a header:\n" + output)
+    return output[start:]
+
+
+class Runner:
+    def __init__(self, json_to_cpp, serve_dir, work_dir):
+        self.json_to_cpp = json_to_cpp
+        self.serve_dir = serve_dir
+        self.work_dir = work_dir
+        # The server is local, a proxy from the environment must not be used
+        self.env = dict(os.environ, no_proxy="*", NO_PROXY="*")
+
+    def run(self, *args):
+        return subprocess.run([self.json_to_cpp, *args], cwd=self.work_dir, env=self.env,
+                              stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True, timeout=60)
+
+    def header(self, *args):
+        result = self.run(*args)
+        if result.returncode != 0:
+            raise AssertionError("json_to_cpp {} failed:\n{}".format(" ".join(args), result.stderr))
+        return header_of(result.stdout)
+
+
+def expect_equal(name, actual, expected):
+    if actual != expected:
+        raise AssertionError("{}: the header differs\n--- expected\n{}\n--- actual\n{}".format(name, expected, actual))
+    print(name + ": ok")
+
+
+def main():
+    json_to_cpp, fixtures, golden, work_dir = sys.argv[1:5]
+    json_to_cpp = os.path.abspath(json_to_cpp)
+    serve_dir = os.path.join(work_dir, "served")
+    shutil.rmtree(serve_dir, ignore_errors=True)
+    os.makedirs(serve_dir)
+    for name in ("basic.json", "merge_1.json", "merge_2.json", "merge_3.json"):
+        shutil.copy(os.path.join(fixtures, name), serve_dir)
+    # Larger than the buffer of a download, so the transfer is paused and
+    # resumed while it is parsed
+    with open(os.path.join(serve_dir, "large.json"), "w") as large:
+        json.dump([{"id": n, "name": "item {}".format(n), "price": n * 0.25, "tags": ["a"] * (n % 4)}
+                   for n in range(20000)], large)
+
+    handler = functools.partial(http.server.SimpleHTTPRequestHandler, directory=serve_dir)
+    handler.func.log_message = lambda *args: None
+    server = http.server.ThreadingHTTPServer(("127.0.0.1", 0), handler)
+    thread = threading.Thread(target=server.serve_forever, daemon=True)
+    thread.start()
+    base = "http://127.0.0.1:{}/".format(server.server_address[1])
+    runner = Runner(json_to_cpp, serve_dir, work_dir)
+    try:
+        with open(os.path.join(golden, "basic.h")) as f:
+            expect_equal("download", runner.header("--in_file", base + "basic.json"), f.read())
+
+        url_list = os.path.join(work_dir, "urls.txt")
+        with open(url_list, "w") as f:
+            for n in (1, 2, 3):
+                f.write("{}merge_{}.json\n".format(base, n))
+        with open(os.path.join(golden, "merged.h")) as f:
+            merged = f.read()
+        expect_equal("merge", runner.header("--url_list", url_list, "--max_connections", "2"), merged)
+        expect_equal("merge_one_connection", runner.header("--url_list", url_list, "--max_connections", "1"),
+                     merged)
+
+        expect_equal("large", runner.header("--in_file", base + "large.json"),
+                     runner.header("--in_file", os.path.join(serve_dir, "large.json")))
+
+        result = runner.run("--in_file", base + "basic.json", "--in_file", base + "missing.json")
+        if result.returncode == 0 or "Could not download json data from '" + base + "missing.json'" not in result.stderr:
+            raise AssertionError("missing url: expected a download error, got {}:\n{}".format(result.returncode,
+                                                                                             result.stderr))
+        print("missing url: ok")
+    finally:
+        server.shutdown()
+        server.server_close()
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except AssertionError as error:
+        print(error, file=sys.stderr)
+        sys.exit(1)
@@ -0,0 +1,93 @@
+# Copyright (c) Darrell Wright
+#
+# Distributed under the Boost Software License, Version 1.0. (See accompanying
+# file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+#
+# Official repository: https://github.com/beached/json_to_cpp
+#
+
+# Runs json_to_cpp on a fixture and checks the result.  Run with cmake -P and
+#   JSON_TO_CPP  the executable
+#   FIXTURES     the directory of the inputs, json_to_cpp is run in it
+#   WORK_DIR     a directory for the files of the test
+#   INPUT        the input, relative to FIXTURES
+#   ARGS         more options, separated by ;
+#   PRIME_ARGS   the options of the run that fills the cache in cache mode
+#   MODE         golden    the header must be equal to GOLDEN
+#                error     json_to_cpp must fail with an error matching ERROR
+#                snapshot  the header must be equal to GOLDEN when generated
+#                          from the input and from a snapshot of it
+#                load      the header generated from the snapshot INPUT must be
+#                          equal to GOLDEN
+#                cache     after a run with PRIME_ARGS has filled a cache, a run
+#                          with ARGS must fail with an error matching ERROR
+# The comment naming the inputs is not compared, it differs between the modes
+
+function(run_json_to_cpp result_var)
+    execute_process(
+            COMMAND "${JSON_TO_CPP}" ${ARGN}
+            WORKING_DIRECTORY "${FIXTURES}"
+            RESULT_VARIABLE result
+            OUTPUT_VARIABLE output
+            ERROR_VARIABLE error)
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "json_to_cpp ${ARGN} failed with ${result}:\n${error}")
+    endif ()
+    # Everything before #pragma once is the comment
+    string(FIND "${output}" "#pragma once" start)
+    if (start LESS 0)
+        message(FATAL_ERROR "json_to_cpp ${ARGN} did not write a header:\n${output}")
+    endif ()
+    string(SUBSTRING "${output}" ${start} -1 output)
+    set(${result_var} "${output}" PARENT_SCOPE)
+endfunction()
+
+function(expect_error)
+    execute_process(
+            COMMAND "${JSON_TO_CPP}" ${ARGN}
+            WORKING_DIRECTORY "${FIXTURES}"
+            RESULT_VARIABLE result
+            OUTPUT_QUIET
+            ERROR_VARIABLE error)
+    if (result EQUAL 0)
+        message(FATAL_ERROR "json_to_cpp ${ARGN} did not fail")
+    endif ()
+    if (NOT error MATCHES "${ERROR}")
+        message(FATAL_ERROR "Expected an error matching '${ERROR}', got:\n${error}")
+    endif ()
+endfunction()
+
+function(compare_golden header)
+    file(READ "${GOLDEN}" expected)
+    if (NOT header STREQUAL expected)
+        get_filename_component(name "${GOLDEN}" NAME)
+        file(WRITE "${WORK_DIR}/${name}" "${header}")
+        message(FATAL_ERROR "The header differs from ${GOLDEN}, it was written to ${WORK_DIR}/${name}")
+    endif ()
+endfunction()
+
+file(MAKE_DIRECTORY "${WORK_DIR}")
+
+if (MODE STREQUAL "golden")
+    run_json_to_cpp(header --in_file "${INPUT}" ${ARGS})
+    compare_golden("${header}")
+elseif (MODE STREQUAL "error")
+    expect_error(--in_file "${INPUT}" ${ARGS})
+elseif (MODE STREQUAL "snapshot")
+    set(snapshot "${WORK_DIR}/schema.snap")
+    file(REMOVE "${snapshot}")
+    run_json_to_cpp(header --in_file "${INPUT}" --save_snapshot "${snapshot}" ${ARGS})
+    compare_golden("${header}")
+    run_json_to_cpp(header --load_snapshot "${snapshot}" ${ARGS})
+    compare_golden("${header}")
+elseif (MODE STREQUAL "load")
+    run_json_to_cpp(header --load_snapshot "${INPUT}" ${ARGS})
+    compare_golden("${header}")
+elseif (MODE STREQUAL "cache")
+    set(cache "${WORK_DIR}/cache")
+    file(REMOVE_RECURSE "${cache}")
+    run_json_to_cpp(header --in_file "${INPUT}" --cache_dir "${cache}" ${PRIME_ARGS})
+    expect_error(--in_file "${INPUT}" --cache_dir "${cache}" ${ARGS})
+else ()
+    message(FATAL_ERROR "Unknown MODE '${MODE}'")
+endif ()